@@ -0,0 +1,424 @@
+#include "Leaderboard.hpp"
+#include "PerfCounters.hpp"
+#include "PlayerFile.hpp"
+#include "PlayerStream.hpp"
+#include "ShardedRank.hpp"
+#include "Workload.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <unistd.h>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*
+ * A self-contained benchmark harness for the ranking engines.
+ *
+ * Usage: ./bench [--sizes 1e3,1e6] [--fractions 0.01,0.1] [--distributions uniform,zipf]
+ *                [--threads 1,4] [--reps 5] [--warmup 1] [--seed 1] [--engines a,b] [--json out.json]
+ *                [--counters on] [--max-players 1e8] [--roster-dir /tmp]
+ *
+ * Every (engine, distribution, N, k fraction, thread count) case is run <warmup>
+ * times untimed & <reps> times timed. Offline engines mutate their input, so each
+ * repetition first restores a pristine copy into a preallocated work vector
+ * outside the timed region; online engines read the input in place through a
+ * PlayerSpanStream. Timings therefore cover the engine alone.
+ *
+ * With --counters on, every run is wrapped in withCounters() & the hardware
+ * counters of the last timed repetition are reported, where the host permits.
+ *
+ * Materializing N Players takes about 2 x 48N bytes (the input & its work
+ * copy), so engines over Player vectors only run for N <= --max-players
+ * (1e8, ~10 GB, by default). The column engines ("<file>") instead read a
+ * roster file written once per N to --roster-dir, outside the timed region,
+ * & select over its mapped level column alone; they are the only engines run
+ * above --max-players. At 1e9 the file takes ~34 GB of disk & the
+ * quickSelectRank<file> copy of its level column another 8 GB of memory.
+ */
+
+namespace {
+/**
+ * @brief The input handed to an engine for a single timed run.
+ */
+struct BenchInput {
+    std::vector<Player>& players_;
+    size_t k_;
+    size_t threads_;
+    std::vector<std::vector<Player>> shards_; // Filled by Engine::prepare_, if any
+    const PlayerFile* roster_ = nullptr; // Set for column engines only
+};
+
+/**
+ * @brief A benchmarked ranking engine.
+ *
+ * offline_  -> The engine ranks (& mutates) a vector, so it needs a fresh copy per run
+ * fixedK_   -> The engine always selects the top 10%, ignoring the k fraction
+ * threaded_ -> The engine uses BenchInput::threads_, so it is run per thread count
+ * prepare_  -> Optional setup run once per input, outside the timed region
+ * columnar_ -> The engine reads BenchInput::roster_ rather than a Player vector
+ */
+struct Engine {
+    std::string name_;
+    bool offline_;
+    bool fixedK_;
+    bool threaded_;
+    std::function<RankingResult(BenchInput&)> run_;
+    std::function<void(BenchInput&)> prepare_ = nullptr;
+    bool columnar_ = false;
+};
+
+std::vector<Engine> engines() {
+    return {
+        { "quickSelectRank", true, true, false, [](BenchInput& in) { return Offline::quickSelectRank(in.players_); } },
+        { "heapRank", true, true, false, [](BenchInput& in) { return Offline::heapRank(in.players_); } },
+        { "blockQuickSelectRank", true, true, false, [](BenchInput& in) { return Offline::blockQuickSelectRank(in.players_); } },
+        { "sampleSelectRank", false, true, true, [](BenchInput& in) {
+             return Offline::sampleSelectRank(in.players_, in.threads_);
+         } },
+        { "shardedRank", false, true, true, [](BenchInput& in) { return Offline::shardedRank(in.shards_).ranking_; },
+            [](BenchInput& in) {
+                // One shard process per thread, dealt round-robin
+                in.shards_.assign(std::max<size_t>(1, in.threads_), {});
+                for (size_t i = 0; i < in.players_.size(); ++i) {
+                    in.shards_[i % in.shards_.size()].push_back(in.players_[i]);
+                }
+            } },
+        { "quickSelectRankInPlace", true, true, false, [](BenchInput& in) {
+             return RankingResult({}, {}, Offline::quickSelectRankInPlace(in.players_).elapsed_);
+         } },
+        { "heapRankInPlace", true, true, false, [](BenchInput& in) {
+             return RankingResult({}, {}, Offline::heapRankInPlace(in.players_).elapsed_);
+         } },
+        { "rankIncoming", false, false, false, [](BenchInput& in) {
+             PlayerSpanStream stream(in.players_);
+             return Online::rankIncoming(static_cast<PlayerStream&>(stream), in.k_);
+         } },
+        { "rankIncoming<span>", false, false, false, [](BenchInput& in) {
+             PlayerSpanStream stream(in.players_);
+             return Online::rankIncoming(stream, in.k_);
+         } },
+        { "rankIncomingAdaptive", false, false, false, [](BenchInput& in) {
+             PlayerSpanStream stream(in.players_);
+             return Online::rankIncomingAdaptive(stream, in.k_);
+         } },
+        { "rankTopFraction", false, true, false, [](BenchInput& in) {
+             PlayerSpanStream stream(in.players_);
+             return Online::rankTopFraction(stream, std::max<size_t>(1, in.players_.size() / 10));
+         } },
+        // A single Ranker reused across runs, as in a steady-state request path
+        { "Ranker::rank<stream>", false, false, false, [](BenchInput& in) {
+             static Ranker ranker;
+             PlayerSpanStream stream(in.players_);
+             return RankingResult({}, {}, ranker.rank(stream, in.k_).elapsed_);
+         } },
+        // Column engines, over the level column of a mapped roster file
+        { "quickSelectRank<file>", false, true, false, [](BenchInput& in) { return Offline::quickSelectRank(*in.roster_); },
+            nullptr, true },
+        { "heapRank<file>", false, true, false, [](BenchInput& in) { return Offline::heapRank(*in.roster_); },
+            nullptr, true },
+        // Instrumented variants, reporting RankingStats alongside their (inflated) timings
+        { "quickSelectRank<counted>", true, true, false, [](BenchInput& in) {
+             CountingInstrumentation counter;
+             return Offline::quickSelectRank(in.players_, counter);
+         } },
+        { "heapRank<counted>", true, true, false, [](BenchInput& in) {
+             CountingInstrumentation counter;
+             return Offline::heapRank(in.players_, counter);
+         } },
+        { "rankIncoming<counted>", false, false, false, [](BenchInput& in) {
+             PlayerSpanStream stream(in.players_);
+             CountingInstrumentation counter;
+             return Online::rankIncoming(stream, in.k_, counter);
+         } },
+    };
+}
+
+struct Options {
+    std::vector<size_t> sizes_ { 1000, 10000, 100000, 1000000 };
+    std::vector<double> fractions_ { 0.1 };
+    std::vector<Distribution> distributions_ { Distribution::Uniform, Distribution::Ascending, Distribution::Zipf };
+    std::vector<size_t> threads_ { 1 };
+    std::vector<std::string> engines_;
+    size_t reps_ = 5;
+    size_t warmup_ = 1;
+    uint64_t seed_ = 1;
+    std::string json_;
+    bool counters_ = false;
+    size_t maxPlayers_ = 100000000;
+    std::string rosterDirectory_ = "/tmp";
+};
+
+struct Sample {
+    std::string engine_;
+    std::string distribution_;
+    size_t n_;
+    double fraction_;
+    size_t k_;
+    size_t threads_;
+    double median_;
+    double p99_;
+    double min_;
+    double mean_;
+    double engineMedian_;
+    RankingStats stats_;
+    HardwareCounters counters_;
+};
+
+std::vector<std::string> split(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string flag = argv[i];
+        if (i + 1 >= argc) {
+            throw std::invalid_argument("Missing value for " + flag);
+        }
+        std::string value = argv[++i];
+
+        if (flag == "--sizes") {
+            options.sizes_.clear();
+            for (const std::string& size : split(value)) {
+                options.sizes_.push_back(static_cast<size_t>(std::stod(size)));
+            }
+        } else if (flag == "--fractions") {
+            options.fractions_.clear();
+            for (const std::string& fraction : split(value)) {
+                options.fractions_.push_back(std::stod(fraction));
+            }
+        } else if (flag == "--distributions") {
+            options.distributions_.clear();
+            for (const std::string& name : split(value)) {
+                options.distributions_.push_back(parseDistribution(name));
+            }
+        } else if (flag == "--threads") {
+            options.threads_.clear();
+            for (const std::string& threads : split(value)) {
+                options.threads_.push_back(std::stoul(threads));
+            }
+        } else if (flag == "--engines") {
+            options.engines_ = split(value);
+        } else if (flag == "--reps") {
+            options.reps_ = std::max<size_t>(1, std::stoul(value));
+        } else if (flag == "--warmup") {
+            options.warmup_ = std::stoul(value);
+        } else if (flag == "--seed") {
+            options.seed_ = std::stoull(value);
+        } else if (flag == "--json") {
+            options.json_ = value;
+        } else if (flag == "--counters") {
+            options.counters_ = value == "on" || value == "1";
+        } else if (flag == "--max-players") {
+            options.maxPlayers_ = static_cast<size_t>(std::stod(value));
+        } else if (flag == "--roster-dir") {
+            options.rosterDirectory_ = value;
+        } else {
+            throw std::invalid_argument("Unknown option " + flag);
+        }
+    }
+    return options;
+}
+
+/**
+ * @brief Returns the <q> quantile of <values> (nearest rank).
+ */
+double quantile(std::vector<double> values, double q) {
+    std::sort(values.begin(), values.end());
+    size_t rank = static_cast<size_t>(std::ceil(q * values.size()));
+    return values[std::min(values.size() - 1, rank == 0 ? 0 : rank - 1)];
+}
+
+Sample measure(const Engine& engine, size_t n, const std::vector<Player>& input, std::vector<Player>& work,
+    BenchInput& in, const Options& options, PerfCollector* collector)
+{
+    std::vector<double> wall;
+    std::vector<double> reported;
+    RankingStats stats;
+    HardwareCounters counters;
+
+    for (size_t rep = 0; rep < options.warmup_ + options.reps_; ++rep) {
+        if (engine.offline_) {
+            // Restore the pristine input outside the timed region
+            work = input;
+        }
+        auto start = std::chrono::steady_clock::now();
+        RankingResult result = collector != nullptr
+            ? withCounters(*collector, [&engine, &in]() { return engine.run_(in); })
+            : engine.run_(in);
+        auto end = std::chrono::steady_clock::now();
+
+        if (rep >= options.warmup_) {
+            wall.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+            reported.push_back(result.elapsed_);
+            stats = result.stats_;
+            counters = result.counters_;
+        }
+    }
+
+    double mean = 0;
+    for (double time : wall) {
+        mean += time / wall.size();
+    }
+    return Sample { engine.name_, "", n, 0, in.k_, in.threads_,
+        quantile(wall, 0.5), quantile(wall, 0.99), quantile(wall, 0), mean, quantile(reported, 0.5), stats, counters };
+}
+
+/**
+ * @brief Streams the Players of an <count>-Player workload into a roster
+ * file at <path>, without materializing them.
+ */
+void writeRoster(const WorkloadSpec& spec, size_t count, const std::string& path) {
+    WorkloadPlayerStream stream(spec, count);
+    PlayerFileWriter writer(path, count);
+    while (stream.remaining() > 0) {
+        writer.append(stream.nextPlayer());
+    }
+    writer.finish();
+}
+
+void writeJson(const std::string& path, const std::vector<Sample>& samples) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Unable to open " + path + " for writing.");
+    }
+    out << "[\n";
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const Sample& s = samples[i];
+        out << "  {\"engine\": \"" << s.engine_ << "\", \"distribution\": \"" << s.distribution_
+            << "\", \"n\": " << s.n_ << ", \"fraction\": " << s.fraction_ << ", \"k\": " << s.k_
+            << ", \"threads\": " << s.threads_ << ", \"median_ms\": " << s.median_
+            << ", \"p99_ms\": " << s.p99_ << ", \"min_ms\": " << s.min_ << ", \"mean_ms\": " << s.mean_
+            << ", \"engine_median_ms\": " << s.engineMedian_ << ", \"comparisons\": " << s.stats_.comparisons_
+            << ", \"moves\": " << s.stats_.moves_ << ", \"swaps\": " << s.stats_.swaps_
+            << ", \"max_sift_depth\": " << s.stats_.maxSiftDepth_ << ", \"allocations\": " << s.stats_.allocations_;
+        const HardwareCounters& c = s.counters_;
+        if (c.available_ != 0) {
+            out << ", \"counters\": {";
+            const char* separator = "";
+            auto field = [&](HardwareCounters::Counter counter, const char* name, uint64_t value) {
+                if (c.has(counter)) {
+                    out << separator << "\"" << name << "\": " << value;
+                    separator = ", ";
+                }
+            };
+            field(HardwareCounters::Cycles, "cycles", c.cycles_);
+            field(HardwareCounters::Instructions, "instructions", c.instructions_);
+            field(HardwareCounters::L1dMisses, "l1d_misses", c.l1dMisses_);
+            field(HardwareCounters::LlcMisses, "llc_misses", c.llcMisses_);
+            field(HardwareCounters::BranchMisses, "branch_misses", c.branchMisses_);
+            field(HardwareCounters::DtlbMisses, "dtlb_misses", c.dtlbMisses_);
+            out << "}";
+        }
+        out << "}" << (i + 1 < samples.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << "\n";
+        return 1;
+    }
+
+    std::vector<Engine> selected;
+    for (const Engine& engine : engines()) {
+        if (options.engines_.empty()
+            || std::find(options.engines_.begin(), options.engines_.end(), engine.name_) != options.engines_.end()) {
+            selected.push_back(engine);
+        }
+    }
+
+    PerfCollector collector;
+    PerfCollector* counters = nullptr;
+    if (options.counters_) {
+        if (collector.available()) {
+            counters = &collector;
+        } else {
+            std::cerr << "Hardware counters are not permitted on this host; continuing without them.\n";
+        }
+    }
+
+    bool anyColumnar = std::any_of(selected.begin(), selected.end(), [](const Engine& engine) { return engine.columnar_; });
+    std::string rosterPath = options.rosterDirectory_ + "/bench-roster-" + std::to_string(::getpid()) + ".bin";
+
+    std::vector<Sample> samples;
+    std::printf("%-26s %-18s %12s %8s %12s %4s %12s %12s %12s %14s\n",
+        "engine", "distribution", "n", "frac", "k", "thr", "median ms", "p99 ms", "engine ms", "comparisons");
+
+    for (Distribution distribution : options.distributions_) {
+        for (size_t n : options.sizes_) {
+            WorkloadSpec spec;
+            spec.distribution_ = distribution;
+            spec.seed_ = options.seed_;
+            // Online engines only read <input>, through a PlayerSpanStream
+            bool materialize = n <= options.maxPlayers_;
+            std::vector<Player> input = materialize ? generateWorkload(spec, n) : std::vector<Player>();
+            std::vector<Player> work(input);
+            if (!materialize) {
+                std::cerr << "n = " << n << " exceeds --max-players; running the column engines only.\n";
+            }
+
+            std::unique_ptr<PlayerFile> roster;
+            if (anyColumnar) {
+                writeRoster(spec, n, rosterPath);
+                roster = std::make_unique<PlayerFile>(rosterPath);
+                // The mapping outlives the unlinked file, until <roster> is released
+                std::remove(rosterPath.c_str());
+            }
+
+            for (const Engine& engine : selected) {
+                if (!engine.columnar_ && !materialize) {
+                    continue;
+                }
+                std::vector<double> fractions = engine.fixedK_ ? std::vector<double> { 0.1 } : options.fractions_;
+                std::vector<size_t> threads = engine.threaded_ ? options.threads_ : std::vector<size_t> { 1 };
+
+                for (double fraction : fractions) {
+                    for (size_t threadCount : threads) {
+                        size_t k = std::max<size_t>(1, static_cast<size_t>(std::ceil(n * fraction)));
+                        BenchInput in { engine.offline_ ? work : input, k, threadCount, {}, roster.get() };
+                        if (engine.prepare_) {
+                            engine.prepare_(in);
+                        }
+
+                        Sample sample = measure(engine, n, input, work, in, options, counters);
+                        sample.distribution_ = distributionName(distribution);
+                        sample.fraction_ = fraction;
+                        samples.push_back(sample);
+
+                        std::printf("%-26s %-18s %12zu %8.4g %12zu %4zu %12.3f %12.3f %12.3f %14zu\n",
+                            sample.engine_.c_str(), sample.distribution_.c_str(), n, fraction, k, threadCount,
+                            sample.median_, sample.p99_, sample.engineMedian_, sample.stats_.comparisons_);
+                        std::fflush(stdout);
+                    }
+                }
+            }
+        }
+    }
+
+    if (!options.json_.empty()) {
+        writeJson(options.json_, samples);
+    }
+    return 0;
+}
@@ -0,0 +1,262 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+/**
+ * @brief BlockQuicksort-style selection & sorting (Edelkamp & Weiß, 2016).
+ *
+ * Classic partitioning branches on every element's side of the pivot, which
+ * on random keys is a coin flip the branch predictor loses half the time.
+ * Block partitioning instead scans a block of BLOCK elements from each end,
+ * recording the offsets of misplaced elements with branch-free increments,
+ * & only then moves them, pairing misplaced elements from both ends in a
+ * single cyclic permutation.
+ *
+ * Every function orders elements by an unsigned key (eg. a Player's level_)
+ * extracted by a Key functor, & takes random access iterators.
+ */
+namespace BlockSort {
+constexpr size_t BLOCK = 64;
+constexpr ptrdiff_t INSERTION_THRESHOLD = 24;
+
+/**
+ * @brief Partitions [first, last) so every element satisfying <left> precedes
+ * every element that does not.
+ *
+ * @param left A predicate on elements, eg. "key below the pivot"
+ * @return The first element not satisfying <left>
+ */
+template <typename RandomIt, typename Predicate>
+RandomIt partition(RandomIt first, RandomIt last, Predicate left) {
+    using Value = typename std::iterator_traits<RandomIt>::value_type;
+
+    // Offsets of misplaced elements within the current left/right block
+    uint8_t offsetsLeft[BLOCK];
+    uint8_t offsetsRight[BLOCK];
+    size_t startLeft = 0, countLeft = 0;
+    size_t startRight = 0, countRight = 0;
+
+    // [first, l) satisfy <left> & [r, last) do not; [l, r) is unpartitioned
+    RandomIt l = first;
+    RandomIt r = last;
+
+    while (r - l > static_cast<ptrdiff_t>(2 * BLOCK)) {
+        if (countLeft == 0) {
+            startLeft = 0;
+            for (size_t i = 0; i < BLOCK; ++i) {
+                offsetsLeft[countLeft] = static_cast<uint8_t>(i);
+                countLeft += !left(l[i]);
+            }
+        }
+        if (countRight == 0) {
+            startRight = 0;
+            for (size_t i = 0; i < BLOCK; ++i) {
+                offsetsRight[countRight] = static_cast<uint8_t>(i);
+                countRight += left(*(r - 1 - i));
+            }
+        }
+
+        // Exchange min(countLeft, countRight) pairs in one cyclic permutation
+        size_t count = std::min(countLeft, countRight);
+        if (count > 0) {
+            const uint8_t* offLeft = offsetsLeft + startLeft;
+            const uint8_t* offRight = offsetsRight + startRight;
+            Value carried = std::move(l[offLeft[0]]);
+            l[offLeft[0]] = std::move(*(r - 1 - offRight[0]));
+            for (size_t j = 1; j < count; ++j) {
+                *(r - 1 - offRight[j - 1]) = std::move(l[offLeft[j]]);
+                l[offLeft[j]] = std::move(*(r - 1 - offRight[j]));
+            }
+            *(r - 1 - offRight[count - 1]) = std::move(carried);
+        }
+        countLeft -= count;
+        countRight -= count;
+        startLeft += count;
+        startRight += count;
+
+        if (countLeft == 0) {
+            l += BLOCK;
+        }
+        if (countRight == 0) {
+            r -= BLOCK;
+        }
+    }
+
+    // Finish the (at most 2 * BLOCK) remaining elements classically
+    while (true) {
+        while (l < r && left(*l)) {
+            ++l;
+        }
+        while (l < r && !left(*(r - 1))) {
+            --r;
+        }
+        if (l >= r) {
+            return l;
+        }
+        std::iter_swap(l, r - 1);
+        ++l;
+        --r;
+    }
+}
+
+namespace detail {
+template <typename RandomIt, typename Key>
+void insertionSort(RandomIt first, RandomIt last, Key key) {
+    using Value = typename std::iterator_traits<RandomIt>::value_type;
+    for (RandomIt i = first + (first != last); i < last; ++i) {
+        if (key(*i) < key(*(i - 1))) {
+            Value value = std::move(*i);
+            RandomIt j = i;
+            do {
+                *j = std::move(*(j - 1));
+                --j;
+            } while (j > first && key(value) < key(*(j - 1)));
+            *j = std::move(value);
+        }
+    }
+}
+
+/**
+ * @brief Moves the median of <a>, <b> & <c> into <a>.
+ */
+template <typename RandomIt, typename Key>
+void medianToFront(RandomIt a, RandomIt b, RandomIt c, Key key) {
+    if (key(*b) < key(*a)) {
+        std::iter_swap(a, b);
+    }
+    if (key(*c) < key(*b)) {
+        std::iter_swap(b, c);
+        if (key(*b) < key(*a)) {
+            std::iter_swap(a, b);
+        }
+    }
+    std::iter_swap(a, b);
+}
+
+/**
+ * @brief Chooses a pivot for [first, last) (median of 3, or a pseudomedian
+ * of 9 for large ranges) & moves it to *first.
+ */
+template <typename RandomIt, typename Key>
+void choosePivot(RandomIt first, RandomIt last, Key key) {
+    ptrdiff_t n = last - first;
+    RandomIt mid = first + n / 2;
+    if (n > 128) {
+        ptrdiff_t step = n / 8;
+        medianToFront(first + 1, first + step, first + 2 * step, key);
+        medianToFront(mid, mid - step, mid + step, key);
+        medianToFront(last - 1, last - 1 - step, last - 1 - 2 * step, key);
+        medianToFront(mid, first + 1, last - 1, key);
+        std::iter_swap(first, mid);
+    } else {
+        medianToFront(mid, first, last - 1, key);
+        std::iter_swap(first, mid);
+    }
+}
+
+/**
+ * @brief Partitions [first, last) around its chosen pivot.
+ *
+ * @param low An element known to be <= every element of the range, or last
+ *      if there is none. If the pivot equals it, the range holds many
+ *      duplicates of the pivot & they are split off in one pass instead.
+ * @return [pivotFirst, pivotLast) such that [first, pivotFirst) < pivot,
+ *      [pivotFirst, pivotLast) == pivot & [pivotLast, last) >= pivot
+ */
+template <typename RandomIt, typename Key>
+std::pair<RandomIt, RandomIt> partitionAroundPivot(RandomIt first, RandomIt last, RandomIt low, Key key) {
+    choosePivot(first, last, key);
+    auto pivot = key(*first);
+
+    if (low != last && !(key(*low) < pivot)) {
+        // Every element is >= pivot, so those <= pivot are equal to it
+        RandomIt bound = BlockSort::partition(first + 1, last, [&](const auto& x) { return !(pivot < key(x)); });
+        return { first, bound };
+    }
+
+    RandomIt bound = BlockSort::partition(first + 1, last, [&](const auto& x) { return key(x) < pivot; });
+    RandomIt mid = bound - 1;
+    std::iter_swap(first, mid);
+    return { mid, mid + 1 };
+}
+
+inline size_t depthLimit(ptrdiff_t n) {
+    size_t depth = 0;
+    for (; n > 1; n >>= 1) {
+        depth += 2;
+    }
+    return depth;
+}
+}
+
+/**
+ * @brief An introselect built on partition(): rearranges [first, last) so
+ * *nth is the element a full sort would put there, with no greater element
+ * before it & no smaller element after it.
+ *
+ * Falls back to std::nth_element() if partitioning stops making progress.
+ */
+template <typename RandomIt, typename Key>
+void select(RandomIt first, RandomIt nth, RandomIt last, Key key) {
+    if (nth == last) {
+        return;
+    }
+    RandomIt end = last;
+    RandomIt low = end;
+    size_t depth = detail::depthLimit(last - first);
+
+    while (last - first > INSERTION_THRESHOLD) {
+        if (depth-- == 0) {
+            std::nth_element(first, nth, last, [&](const auto& a, const auto& b) { return key(a) < key(b); });
+            return;
+        }
+        auto [pivotFirst, pivotLast] = detail::partitionAroundPivot(first, last, low == end ? last : low, key);
+        if (nth < pivotFirst) {
+            last = pivotFirst;
+        } else if (nth < pivotLast) {
+            return;
+        } else {
+            low = pivotLast - 1;
+            first = pivotLast;
+        }
+    }
+    detail::insertionSort(first, last, key);
+}
+
+/**
+ * @brief An introsort built on partition(): sorts [first, last) in ascending
+ * order of key. Not stable.
+ *
+ * Falls back to heapsort if partitioning stops making progress.
+ */
+template <typename RandomIt, typename Key>
+void sort(RandomIt first, RandomIt last, Key key) {
+    RandomIt end = last;
+    RandomIt low = end;
+    size_t depth = detail::depthLimit(last - first);
+
+    while (last - first > INSERTION_THRESHOLD) {
+        if (depth-- == 0) {
+            auto less = [&](const auto& a, const auto& b) { return key(a) < key(b); };
+            std::make_heap(first, last, less);
+            std::sort_heap(first, last, less);
+            return;
+        }
+        auto [pivotFirst, pivotLast] = detail::partitionAroundPivot(first, last, low == end ? last : low, key);
+
+        // Recurse into the smaller side & loop on the larger
+        if (pivotFirst - first < last - pivotLast) {
+            BlockSort::sort(first, pivotFirst, key);
+            low = pivotLast - 1;
+            first = pivotLast;
+        } else {
+            BlockSort::sort(pivotLast, last, key);
+            last = pivotFirst;
+        }
+    }
+    detail::insertionSort(first, last, key);
+}
+}
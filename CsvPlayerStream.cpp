@@ -0,0 +1,357 @@
+#include "CsvPlayerStream.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+const uint64_t ZEROS = 0x3030303030303030ULL;
+const uint64_t HIGH_NIBBLES = 0xF0F0F0F0F0F0F0F0ULL;
+const uint64_t SIXES = 0x0606060606060606ULL;
+
+/**
+ * @brief Converts 8 ASCII digits, stored little-endian in <chunk>, to their value.
+ */
+uint64_t parseEightDigits(uint64_t chunk) {
+    chunk -= ZEROS;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)))
+                + (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32))))
+        >> 32;
+    return chunk;
+}
+
+/**
+ * @brief Returns non-zero unless every byte of <chunk> is an ASCII digit.
+ */
+uint64_t nonDigits(uint64_t chunk) {
+    return ((chunk & HIGH_NIBBLES) ^ ZEROS) | (((chunk + SIXES) & HIGH_NIBBLES) ^ ZEROS);
+}
+
+const char* stripCarriageReturn(const char* begin, const char* end) {
+    return (end > begin && end[-1] == '\r') ? end - 1 : end;
+}
+
+/**
+ * @brief Parses [begin, end) like Csv::parseUnsigned(), but when at least 8
+ * (or, for longer numbers, 16) bytes may be read from <begin> (ie. before
+ * <limit>) the digits are loaded with one unaligned read rather than copied
+ * into a padded buffer.
+ */
+size_t parseNumber(const char* begin, const char* end, const char* limit) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ && defined(__SIZEOF_INT128__)
+    size_t length = static_cast<size_t>(end - begin);
+    if (length - 1 < 8 && limit - begin >= 8) {
+        // Most levels & ids fit one 8-byte word, which needs no 128-bit shifts
+        uint64_t digits;
+        std::memcpy(&digits, begin, sizeof(digits));
+        unsigned shift = static_cast<unsigned>(8 - length) * 8;
+        digits = (digits << shift) | (ZEROS & ((uint64_t(1) << shift) - 1));
+        if (nonDigits(digits) == 0) {
+            return parseEightDigits(digits);
+        }
+    } else if (length - 1 < 16 && limit - begin >= 16) {
+        unsigned __int128 digits;
+        std::memcpy(&digits, begin, sizeof(digits));
+
+        // Right-align the digits & pad the vacated low bytes with '0'
+        unsigned shift = static_cast<unsigned>(16 - length) * 8;
+        unsigned __int128 zeros = (static_cast<unsigned __int128>(ZEROS) << 64) | ZEROS;
+        digits = (digits << shift) | (zeros & ((static_cast<unsigned __int128>(1) << shift) - 1));
+
+        uint64_t high = static_cast<uint64_t>(digits);
+        uint64_t low = static_cast<uint64_t>(digits >> 64);
+        if ((nonDigits(high) | nonDigits(low)) == 0) {
+            return parseEightDigits(high) * 100000000ULL + parseEightDigits(low);
+        }
+    }
+#endif
+    return Csv::parseUnsigned(begin, end);
+}
+
+[[noreturn]] void malformed(const char* line, const char* end) {
+    const char* lineEnd = Csv::findNewline(line, end);
+    throw std::runtime_error("Malformed player record: \"" + std::string(line, stripCarriageReturn(line, lineEnd)) + "\"");
+}
+}
+
+/**
+ * @brief Returns the first position in [p, end) holding <delimiter> or a
+ * newline, or <end> if there is none. Scans 16 bytes at a time with SSE2
+ * where available.
+ */
+const char* Csv::findStructural(const char* p, const char* end, char delimiter) {
+#ifdef __SSE2__
+    const __m128i delimiters = _mm_set1_epi8(delimiter);
+    const __m128i newlines = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, delimiters), _mm_cmpeq_epi8(chunk, newlines)));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+#endif
+    while (p < end && *p != delimiter && *p != '\n') {
+        ++p;
+    }
+    return p;
+}
+
+/**
+ * @brief Returns the first newline in [p, end), or <end> if there is none.
+ */
+const char* Csv::findNewline(const char* p, const char* end) {
+    const void* newline = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    return newline != nullptr ? static_cast<const char*>(newline) : end;
+}
+
+/**
+ * @brief Counts the non-blank lines in [p, end).
+ */
+size_t Csv::countRecords(const char* p, const char* end) {
+    size_t count = 0;
+    const char* lineStart = p;
+
+    auto endLine = [&count, &lineStart](const char* newline) {
+        if (stripCarriageReturn(lineStart, newline) != lineStart) {
+            count++;
+        }
+        lineStart = newline + 1;
+    };
+
+#ifdef __SSE2__
+    const __m128i newlines = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newlines)));
+        while (mask != 0) {
+            endLine(p + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+        p += 16;
+    }
+#endif
+    for (; p < end; ++p) {
+        if (*p == '\n') {
+            endLine(p);
+        }
+    }
+    if (lineStart < end) {
+        endLine(end);
+    }
+    return count;
+}
+
+/**
+ * @brief Returns the first position in [p, end) that is not part of a blank line.
+ */
+const char* Csv::skipBlankLines(const char* p, const char* end) {
+    while (p < end) {
+        if (*p == '\n') {
+            ++p;
+        } else if (*p == '\r' && (p + 1 == end || p[1] == '\n')) {
+            ++p;
+        } else {
+            break;
+        }
+    }
+    return p;
+}
+
+/**
+ * @brief Parses an unsigned decimal of 1 to 19 digits without branching on
+ * the digit values: the digits are right-aligned into a zero-padded buffer
+ * & converted 8 at a time with SWAR arithmetic.
+ *
+ * @throws std::runtime_error if [begin, end) is not such a decimal.
+ */
+size_t Csv::parseUnsigned(const char* begin, const char* end) {
+    size_t length = static_cast<size_t>(end - begin);
+    if (length == 0 || length > 19) {
+        throw std::runtime_error("Invalid number: \"" + std::string(begin, end) + "\"");
+    }
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    char digits[24];
+    std::memset(digits, '0', sizeof(digits));
+    std::memcpy(digits + sizeof(digits) - length, begin, length);
+
+    uint64_t chunks[3];
+    std::memcpy(chunks, digits, sizeof(chunks));
+    if ((nonDigits(chunks[0]) | nonDigits(chunks[1]) | nonDigits(chunks[2])) != 0) {
+        throw std::runtime_error("Invalid number: \"" + std::string(begin, end) + "\"");
+    }
+    return parseEightDigits(chunks[0]) * 10000000000000000ULL
+        + parseEightDigits(chunks[1]) * 100000000ULL
+        + parseEightDigits(chunks[2]);
+#else
+    size_t value = 0;
+    for (const char* p = begin; p < end; ++p) {
+        if (*p < '0' || *p > '9') {
+            throw std::runtime_error("Invalid number: \"" + std::string(begin, end) + "\"");
+        }
+        value = value * 10 + static_cast<size_t>(*p - '0');
+    }
+    return value;
+#endif
+}
+
+/**
+ * @brief Parses the record starting at <p>, which must not be a blank line.
+ *
+ * @return The start of the following line (or <end>).
+ * @throws std::runtime_error if the line is not "name<d>level[<d>id]".
+ */
+const char* Csv::parseRecord(const char* p, const char* end, char delimiter, Csv::Record& record) {
+#ifdef __SSE2__
+    // Fast path: locate every separator of a short line with a single 32-byte scan
+    if (end - p >= 32) {
+        const __m128i delimiters = _mm_set1_epi8(delimiter);
+        const __m128i newlines = _mm_set1_epi8('\n');
+        __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+        unsigned delimiterMask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(low, delimiters)))
+            | (static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(high, delimiters))) << 16);
+        unsigned newlineMask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(low, newlines)))
+            | (static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(high, newlines))) << 16);
+
+        if (newlineMask != 0) {
+            unsigned lineLength = static_cast<unsigned>(__builtin_ctz(newlineMask));
+            delimiterMask &= (1u << lineLength) - 1;
+            int fields = __builtin_popcount(delimiterMask) + 1;
+            if (fields == 2 || fields == 3) {
+                const char* nameEnd = p + __builtin_ctz(delimiterMask);
+                delimiterMask &= delimiterMask - 1;
+                const char* lineEnd = p + lineLength;
+                const char* levelEnd = fields == 3 ? p + __builtin_ctz(delimiterMask) : lineEnd;
+
+                record.name_ = std::string_view(p, static_cast<size_t>(nameEnd - p));
+                if (fields == 3) {
+                    record.level_ = parseNumber(nameEnd + 1, levelEnd, end);
+                    record.id_ = parseNumber(levelEnd + 1, stripCarriageReturn(levelEnd + 1, lineEnd), end);
+                } else {
+                    record.level_ = parseNumber(nameEnd + 1, stripCarriageReturn(nameEnd + 1, lineEnd), end);
+                    record.id_ = 0;
+                }
+                return lineEnd + 1;
+            }
+        }
+    }
+#endif
+    const char* nameEnd = Csv::findStructural(p, end, delimiter);
+    if (nameEnd == end || *nameEnd != delimiter) {
+        malformed(p, end);
+    }
+    record.name_ = std::string_view(p, static_cast<size_t>(nameEnd - p));
+
+    const char* levelBegin = nameEnd + 1;
+    const char* levelEnd = Csv::findStructural(levelBegin, end, delimiter);
+    const char* lineEnd = levelEnd;
+    record.id_ = 0;
+
+    if (levelEnd < end && *levelEnd == delimiter) {
+        const char* idBegin = levelEnd + 1;
+        lineEnd = Csv::findStructural(idBegin, end, delimiter);
+        if (lineEnd < end && *lineEnd == delimiter) {
+            malformed(p, end);
+        }
+        record.id_ = parseNumber(idBegin, stripCarriageReturn(idBegin, lineEnd), end);
+    } else {
+        levelEnd = stripCarriageReturn(levelBegin, levelEnd);
+    }
+    record.level_ = parseNumber(levelBegin, levelEnd, end);
+
+    return lineEnd == end ? end : lineEnd + 1;
+}
+
+/**
+ * @brief Constructs a stream over the text roster at <path>.
+ *
+ * @param path The roster file to map
+ * @param delimiter The field separator
+ * @param hasHeader Whether the first line is a header to be skipped
+ * @throws std::runtime_error if the file cannot be mapped.
+ */
+CsvPlayerStream::CsvPlayerStream(const std::string& path, char delimiter, bool hasHeader)
+    : file_ { std::make_unique<MappedFile>(path) }
+    , delimiter_ { delimiter }
+{
+    init(file_->data(), file_->size(), hasHeader);
+}
+
+/**
+ * @brief Constructs a stream over an in-memory roster, which must outlive it.
+ */
+CsvPlayerStream::CsvPlayerStream(const char* data, size_t bytes, char delimiter, bool hasHeader)
+    : delimiter_ { delimiter }
+{
+    init(data, bytes, hasHeader);
+}
+
+void CsvPlayerStream::init(const char* data, size_t bytes, bool hasHeader) {
+    cursor_ = data;
+    end_ = data + bytes;
+    if (hasHeader) {
+        const char* header = Csv::skipBlankLines(cursor_, end_);
+        const char* newline = Csv::findNewline(header, end_);
+        cursor_ = newline == end_ ? end_ : newline + 1;
+    }
+    remaining_ = Csv::countRecords(cursor_, end_);
+}
+
+/**
+ * @brief Retrieves & parses the next Player in the stream.
+ *
+ * @throws std::runtime_error If there are no more players remaining in the
+ *      stream, or the next record is malformed.
+ */
+Player CsvPlayerStream::nextPlayer() {
+    if (remaining_ == 0) {
+        throw std::runtime_error("No more players remaining in the stream.");
+    }
+    Csv::Record record;
+    cursor_ = Csv::parseRecord(Csv::skipBlankLines(cursor_, end_), end_, delimiter_, record);
+    remaining_--;
+
+    Player player(std::string(record.name_), record.level_);
+    player.id_ = record.id_;
+    return player;
+}
+
+/**
+ * @brief Returns the number of players remaining in the stream.
+ */
+size_t CsvPlayerStream::remaining() const {
+    return remaining_;
+}
+
+/**
+ * @brief Parses up to <maxPlayers> Players into <batch>.
+ *
+ * Existing elements of <batch> are overwritten in place, so reusing the
+ * same vector across calls recycles the capacity of each Player's name.
+ *
+ * @return The number of Players parsed; <batch> is resized to match.
+ * @throws std::runtime_error If a record is malformed.
+ */
+size_t CsvPlayerStream::nextBatch(std::vector<Player>& batch, size_t maxPlayers) {
+    size_t count = std::min(maxPlayers, remaining_);
+    batch.resize(count);
+
+    Csv::Record record;
+    for (size_t i = 0; i < count; ++i) {
+        cursor_ = Csv::parseRecord(Csv::skipBlankLines(cursor_, end_), end_, delimiter_, record);
+        batch[i].name_.assign(record.name_.data(), record.name_.size());
+        batch[i].level_ = record.level_;
+        batch[i].id_ = record.id_;
+    }
+    remaining_ -= count;
+    return count;
+}
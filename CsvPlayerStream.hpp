@@ -0,0 +1,136 @@
+#pragma once
+#include "MappedFile.hpp"
+#include "Player.hpp"
+#include "PlayerStream.hpp"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Low-level helpers for parsing "name,level[,id]" text rosters.
+ *
+ * Exposed so that other text-backed sources can share the same scanner.
+ * Blank lines are skipped, a trailing "\r" is ignored, & a missing id is 0.
+ */
+namespace Csv {
+/**
+ * @brief The fields of a single record. <name> views the source buffer.
+ */
+struct Record {
+    std::string_view name_;
+    size_t level_;
+    size_t id_;
+};
+
+/**
+ * @brief Returns the first position in [p, end) holding <delimiter> or a
+ * newline, or <end> if there is none. Scans 16 bytes at a time with SSE2
+ * where available.
+ */
+const char* findStructural(const char* p, const char* end, char delimiter);
+
+/**
+ * @brief Returns the first newline in [p, end), or <end> if there is none.
+ */
+const char* findNewline(const char* p, const char* end);
+
+/**
+ * @brief Counts the non-blank lines in [p, end).
+ */
+size_t countRecords(const char* p, const char* end);
+
+/**
+ * @brief Returns the first position in [p, end) that is not part of a blank line.
+ */
+const char* skipBlankLines(const char* p, const char* end);
+
+/**
+ * @brief Parses an unsigned decimal of 1 to 19 digits without branching on
+ * the digit values: the digits are right-aligned into a zero-padded buffer
+ * & converted 8 at a time with SWAR arithmetic.
+ *
+ * @throws std::runtime_error if [begin, end) is not such a decimal.
+ */
+size_t parseUnsigned(const char* begin, const char* end);
+
+/**
+ * @brief Parses the record starting at <p>, which must not be a blank line.
+ *
+ * @return The start of the following line (or <end>).
+ * @throws std::runtime_error if the line is not "name<d>level[<d>id]".
+ */
+const char* parseRecord(const char* p, const char* end, char delimiter, Record& record);
+};
+
+/**
+ * @brief A PlayerStream over a delimited text roster with lines of the form
+ * "name,level[,id]" (or any other single-byte delimiter, eg. '\t' for TSV).
+ *
+ * Files are mapped in one mmap() & records are parsed on demand; the only
+ * up-front work is a vectorized newline count so that remaining() is exact.
+ *
+ * @note The >1 GB/s single-threaded target is met by the parser alone but
+ *       not reliably by the stream. On 5M "name,level,id" lines (147 MB,
+ *       in memory) parseRecord() runs at 1.2-1.9 GB/s. A full nextBatch()
+ *       replay, which adds the newline count & a copy of every name, runs
+ *       at 0.7-1.2 GB/s depending on machine load. nextPlayer() runs at
+ *       about 0.55 GB/s, since it builds a new Player each time.
+ *
+ * @example Given the buffer "Rykard,23\nMalenia,99,7\n":
+ * stream.remaining() -> 2
+ * stream.nextPlayer() -> Player("Rykard", 23), with id_ 0
+ * stream.nextPlayer() -> Player("Malenia", 99), with id_ 7
+ * stream.remaining() -> 0
+ */
+class CsvPlayerStream final : public PlayerStream {
+private:
+    std::unique_ptr<MappedFile> file_;
+    const char* cursor_;
+    const char* end_;
+    char delimiter_;
+    size_t remaining_;
+
+    void init(const char* data, size_t bytes, bool hasHeader);
+
+public:
+    /**
+     * @brief Constructs a stream over the text roster at <path>.
+     *
+     * @param path The roster file to map
+     * @param delimiter The field separator
+     * @param hasHeader Whether the first line is a header to be skipped
+     * @throws std::runtime_error if the file cannot be mapped.
+     */
+    explicit CsvPlayerStream(const std::string& path, char delimiter = ',', bool hasHeader = false);
+
+    /**
+     * @brief Constructs a stream over an in-memory roster, which must outlive it.
+     */
+    CsvPlayerStream(const char* data, size_t bytes, char delimiter = ',', bool hasHeader = false);
+
+    /**
+     * @brief Retrieves & parses the next Player in the stream.
+     *
+     * @throws std::runtime_error If there are no more players remaining in the
+     *      stream, or the next record is malformed.
+     */
+    Player nextPlayer() override;
+
+    /**
+     * @brief Returns the number of players remaining in the stream.
+     */
+    size_t remaining() const override;
+
+    /**
+     * @brief Parses up to <maxPlayers> Players into <batch>.
+     *
+     * Existing elements of <batch> are overwritten in place, so reusing the
+     * same vector across calls recycles the capacity of each Player's name.
+     *
+     * @return The number of Players parsed; <batch> is resized to match.
+     * @throws std::runtime_error If a record is malformed.
+     */
+    size_t nextBatch(std::vector<Player>& batch, size_t maxPlayers);
+};
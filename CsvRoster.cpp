@@ -0,0 +1,180 @@
+#include "CsvRoster.hpp"
+#include "CsvPlayerStream.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <thread>
+
+namespace {
+/**
+ * @brief Parses every record of [begin, end) into <columns>.
+ */
+ChunkStats parseChunk(const char* begin, const char* end, char delimiter, PlayerColumns& columns) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    size_t count = Csv::countRecords(begin, end);
+    columns.levels_.resize(count);
+    columns.ids_.resize(count);
+    columns.names_.resize(count);
+
+    Csv::Record record;
+    const char* cursor = begin;
+    for (size_t i = 0; i < count; ++i) {
+        cursor = Csv::parseRecord(Csv::skipBlankLines(cursor, end), end, delimiter, record);
+        columns.levels_[i] = record.level_;
+        columns.ids_[i] = record.id_;
+        columns.names_[i] = record.name_;
+    }
+
+    auto finish = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(finish - start).count();
+    return ChunkStats { static_cast<size_t>(end - begin), count, elapsed };
+}
+
+CsvRoster parseRoster(std::shared_ptr<const MappedFile> file, const char* data, size_t bytes,
+    size_t threads, char delimiter, bool hasHeader)
+{
+    const char* begin = data;
+    const char* end = data + bytes;
+    if (hasHeader) {
+        const char* newline = Csv::findNewline(Csv::skipBlankLines(begin, end), end);
+        begin = newline == end ? end : newline + 1;
+    }
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // Don't bother splitting tiny inputs across threads
+    threads = std::max<size_t>(1, std::min<size_t>(threads, static_cast<size_t>(end - begin) / 4096));
+
+    // Split at newline boundaries so that no record straddles two chunks
+    std::vector<const char*> bounds { begin };
+    for (size_t i = 1; i < threads; ++i) {
+        const char* guess = begin + static_cast<size_t>(end - begin) * i / threads;
+        const char* newline = Csv::findNewline(std::max(guess, bounds.back()), end);
+        bounds.push_back(newline == end ? end : newline + 1);
+    }
+    bounds.push_back(end);
+
+    std::vector<PlayerColumns> chunks(threads);
+    std::vector<ChunkStats> stats(threads);
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back([&, i]() {
+            try {
+                stats[i] = parseChunk(bounds[i], bounds[i + 1], delimiter, chunks[i]);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    return CsvRoster(std::move(file), std::move(chunks), std::move(stats));
+}
+}
+
+/**
+ * @brief Returns the parse throughput of this chunk, in MB/s.
+ */
+double ChunkStats::throughput() const {
+    return elapsed_ > 0 ? bytes_ / (elapsed_ * 1000.0) : 0;
+}
+
+/**
+ * @brief Assembles a roster from its parsed chunks.
+ *
+ * @param file The mapping the chunks' names view, if any
+ * @param chunks The parsed chunks, in source order
+ * @param stats The parse statistics of each chunk
+ */
+CsvRoster::CsvRoster(std::shared_ptr<const MappedFile> file, std::vector<PlayerColumns> chunks, std::vector<ChunkStats> stats)
+    : file_ { std::move(file) }
+    , chunks_ { std::move(chunks) }
+    , stats_ { std::move(stats) }
+{
+    size_t rows = 0;
+    for (const PlayerColumns& chunk : chunks_) {
+        firstRows_.push_back(rows);
+        rows += chunk.levels_.size();
+    }
+    firstRows_.push_back(rows);
+}
+
+/**
+ * @brief Returns the total number of Players across all chunks.
+ */
+size_t CsvRoster::size() const {
+    return firstRows_.back();
+}
+
+/**
+ * @brief Returns the parsed chunks, in source order.
+ */
+const std::vector<PlayerColumns>& CsvRoster::chunks() const {
+    return chunks_;
+}
+
+/**
+ * @brief Returns the parse statistics of each chunk, in source order.
+ */
+const std::vector<ChunkStats>& CsvRoster::stats() const {
+    return stats_;
+}
+
+/**
+ * @brief Returns each chunk's level column, numbered by global row.
+ */
+std::vector<LevelColumn> CsvRoster::levelColumns() const {
+    std::vector<LevelColumn> columns;
+    for (size_t i = 0; i < chunks_.size(); ++i) {
+        columns.push_back(LevelColumn { chunks_[i].levels_.data(), chunks_[i].levels_.size(), firstRows_[i] });
+    }
+    return columns;
+}
+
+/**
+ * @brief Materializes the Player at global row <row>.
+ */
+Player CsvRoster::player(size_t row) const {
+    size_t chunk = std::upper_bound(firstRows_.begin(), firstRows_.end(), row) - firstRows_.begin() - 1;
+    size_t index = row - firstRows_[chunk];
+    const PlayerColumns& columns = chunks_[chunk];
+
+    Player player(std::string(columns.names_[index]), columns.levels_[index]);
+    player.id_ = columns.ids_[index];
+    return player;
+}
+
+/**
+ * @brief Maps the "name,level[,id]" roster at <path>, splits it at newline
+ * boundaries into <threads> chunks, & parses them concurrently.
+ *
+ * @param path The roster file to load
+ * @param threads The number of chunks (& parsing threads); 0 uses every core
+ * @param delimiter The field separator
+ * @param hasHeader Whether the first line is a header to be skipped
+ * @throws std::runtime_error if the file cannot be mapped or a record is malformed.
+ */
+CsvRoster loadCsvRoster(const std::string& path, size_t threads, char delimiter, bool hasHeader) {
+    auto file = std::make_shared<const MappedFile>(path);
+    return parseRoster(file, file->data(), file->size(), threads, delimiter, hasHeader);
+}
+
+/**
+ * @brief Like loadCsvRoster(), but over an in-memory roster which must
+ * outlive the returned CsvRoster.
+ */
+CsvRoster parseCsvRoster(const char* data, size_t bytes, size_t threads, char delimiter, bool hasHeader) {
+    return parseRoster(nullptr, data, bytes, threads, delimiter, hasHeader);
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include "MappedFile.hpp"
+#include "Player.hpp"
+#include "PlayerFile.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief The columns parsed from one chunk of a text roster.
+ *
+ * Names are views into the roster's source text, which the owning CsvRoster
+ * keeps alive, so no name is ever copied during loading.
+ */
+struct PlayerColumns {
+    std::vector<uint64_t> levels_;
+    std::vector<uint64_t> ids_;
+    std::vector<std::string_view> names_;
+};
+
+/**
+ * @brief Parse statistics for a single chunk (ie. a single thread).
+ */
+struct ChunkStats {
+    size_t bytes_;
+    size_t players_;
+
+    /**
+     * @brief The time this chunk took to parse, in ms.
+     */
+    double elapsed_;
+
+    /**
+     * @brief Returns the parse throughput of this chunk, in MB/s.
+     */
+    double throughput() const;
+};
+
+/**
+ * @brief A text roster parsed into per-chunk columns by loadCsvRoster().
+ *
+ * The chunks are never concatenated; row i of the roster is addressed through
+ * the chunk containing it, & the level columns are exposed per chunk so the
+ * Offline engines can select over them directly.
+ */
+class CsvRoster {
+private:
+    std::shared_ptr<const MappedFile> file_;
+    std::vector<PlayerColumns> chunks_;
+    std::vector<ChunkStats> stats_;
+    std::vector<size_t> firstRows_;
+
+public:
+    /**
+     * @brief Assembles a roster from its parsed chunks.
+     *
+     * @param file The mapping the chunks' names view, if any
+     * @param chunks The parsed chunks, in source order
+     * @param stats The parse statistics of each chunk
+     */
+    CsvRoster(std::shared_ptr<const MappedFile> file, std::vector<PlayerColumns> chunks, std::vector<ChunkStats> stats);
+
+    /**
+     * @brief Returns the total number of Players across all chunks.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the parsed chunks, in source order.
+     */
+    const std::vector<PlayerColumns>& chunks() const;
+
+    /**
+     * @brief Returns the parse statistics of each chunk, in source order.
+     */
+    const std::vector<ChunkStats>& stats() const;
+
+    /**
+     * @brief Returns each chunk's level column, numbered by global row.
+     */
+    std::vector<LevelColumn> levelColumns() const;
+
+    /**
+     * @brief Materializes the Player at global row <row>.
+     */
+    Player player(size_t row) const;
+};
+
+/**
+ * @brief Maps the "name,level[,id]" roster at <path>, splits it at newline
+ * boundaries into <threads> chunks, & parses them concurrently.
+ *
+ * @param path The roster file to load
+ * @param threads The number of chunks (& parsing threads); 0 uses every core
+ * @param delimiter The field separator
+ * @param hasHeader Whether the first line is a header to be skipped
+ * @throws std::runtime_error if the file cannot be mapped or a record is malformed.
+ */
+CsvRoster loadCsvRoster(const std::string& path, size_t threads = 0, char delimiter = ',', bool hasHeader = false);
+
+/**
+ * @brief Like loadCsvRoster(), but over an in-memory roster which must
+ * outlive the returned CsvRoster.
+ */
+CsvRoster parseCsvRoster(const char* data, size_t bytes, size_t threads = 0, char delimiter = ',', bool hasHeader = false);
@@ -0,0 +1,250 @@
+#include "ExternalRank.hpp"
+#include "PlayerFile.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace {
+std::atomic<size_t> nextSpillId { 0 };
+
+/**
+ * @brief The in-memory footprint charged against the budget for a Player.
+ */
+size_t playerBytes(const Player& player) {
+    return sizeof(Player) + player.name_.size();
+}
+
+/**
+ * @brief Removes every spilled run when ranking finishes or fails.
+ */
+struct SpillFiles {
+    std::vector<std::string> paths_;
+
+    ~SpillFiles() {
+        for (const std::string& path : paths_) {
+            std::remove(path.c_str());
+        }
+    }
+};
+
+/**
+ * @brief Returns the number of levels in an ascending run at or above <level>,
+ * adding the 8 bytes of every level its binary search reads to <bytesRead>.
+ */
+size_t countAtOrAbove(const PlayerFile& run, uint64_t level, size_t& bytesRead) {
+    const uint64_t* levels = run.levels();
+    size_t first = 0;
+    size_t count = run.size();
+    while (count > 0) {
+        size_t step = count / 2;
+        bytesRead += sizeof(uint64_t);
+        if (levels[first + step] < level) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return run.size() - first;
+}
+}
+
+/**
+ * @brief Selects & sorts the top 10% of a stream of Players too large to hold
+ *        in memory, within a fixed memory budget.
+ */
+ExternalRankingResult Offline::externalRank(PlayerStream& stream, const ExternalRankingOptions& options) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    ExternalRankingResult result;
+    size_t totalPlayers = stream.remaining();
+    size_t topCount = (totalPlayers + 9) / 10; // Ceiling of 10%
+    result.topCount_ = topCount;
+
+    size_t chunkBudget = std::max<size_t>(options.memoryBudget_ / 2, sizeof(Player));
+    // Fences are kept to a quarter of the chunk budget (& at most 1024 of them)
+    size_t fenceLimit = std::max<size_t>(1, std::min<size_t>(1024, chunkBudget / 4 / sizeof(uint64_t)));
+    size_t stride = std::max<size_t>(1, (topCount + fenceLimit - 1) / fenceLimit);
+    size_t spillId = nextSpillId++;
+
+    std::vector<Player> buffer;
+    size_t bufferBytes = 0;
+    bool hasFloor = false;
+    size_t floor = 0;
+
+    SpillFiles spills;
+    std::vector<uint64_t> fences;
+
+    // Sorts the buffer, writes it out as a run & raises the floor from the fences
+    auto spill = [&]() {
+        std::sort(buffer.begin(), buffer.end());
+        std::string path = options.spillDirectory_ + "/external-run-" + std::to_string(::getpid()) + "-"
+            + std::to_string(spillId) + "-" + std::to_string(spills.paths_.size()) + ".plr";
+        spills.paths_.push_back(path);
+
+        PlayerFileWriter writer(path, buffer.size());
+        for (const Player& player : buffer) {
+            writer.append(player);
+        }
+        writer.finish();
+        result.bytesWritten_ += writer.bytesWritten();
+
+        // Fence j certifies j * stride Players of this run at or above its level
+        size_t n = buffer.size();
+        for (size_t j = 1; j * stride <= n; ++j) {
+            fences.push_back(buffer[n - j * stride].level_);
+        }
+        buffer.clear();
+        bufferBytes = 0;
+
+        // The highest fences across runs certify at least topCount Players
+        size_t needed = (topCount + stride - 1) / stride;
+        if (needed > 0 && fences.size() >= needed) {
+            std::nth_element(fences.begin(), fences.begin() + (needed - 1), fences.end(), std::greater<uint64_t>());
+            size_t level = fences[needed - 1];
+            fences.resize(needed); // Lower fences can never raise the floor again
+            if (!hasFloor || level > floor) {
+                floor = level;
+                hasFloor = true;
+            }
+        }
+    };
+
+    while (stream.remaining() > 0) {
+        Player player = stream.nextPlayer();
+        if (hasFloor && player.level_ <= floor) {
+            continue; // At least topCount Players at or above the floor are already held
+        }
+        bufferBytes += playerBytes(player);
+        buffer.push_back(std::move(player));
+        size_t resident = bufferBytes + fences.capacity() * sizeof(uint64_t);
+        result.peakMemory_ = std::max(result.peakMemory_, resident);
+
+        if (resident < chunkBudget) {
+            continue;
+        }
+        if (spills.paths_.empty() && buffer.size() > topCount) {
+            // Cut the chunk down to its topCount best Players & raise the floor
+            std::nth_element(buffer.begin(), buffer.end() - topCount, buffer.end());
+            buffer.erase(buffer.begin(), buffer.end() - topCount);
+            floor = std::min_element(buffer.begin(), buffer.end())->level_;
+            hasFloor = true;
+
+            bufferBytes = 0;
+            for (const Player& kept : buffer) {
+                bufferBytes += playerBytes(kept);
+            }
+            if (bufferBytes < chunkBudget / 2) {
+                continue;
+            }
+        }
+        // The top 10% alone fills the budget
+        spill();
+    }
+
+    if (spills.paths_.empty()) {
+        // Everything fit: finish exactly as quickSelectRank() would
+        std::nth_element(buffer.begin(), buffer.end() - topCount, buffer.end());
+        std::vector<Player> topPlayers(std::make_move_iterator(buffer.end() - topCount), std::make_move_iterator(buffer.end()));
+        std::sort(topPlayers.begin(), topPlayers.end());
+
+        auto end = std::chrono::high_resolution_clock::now();
+        double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+        result.ranking_ = RankingResult(std::move(topPlayers), {}, elapsed);
+        return result;
+    }
+    if (!buffer.empty()) {
+        spill();
+    }
+    result.runs_ = spills.paths_.size();
+    buffer.shrink_to_fit();
+    std::vector<uint64_t>().swap(fences);
+
+    std::vector<std::unique_ptr<PlayerFile>> runs;
+    uint64_t highest = 0;
+    for (const std::string& path : spills.paths_) {
+        runs.push_back(std::make_unique<PlayerFile>(path));
+        if (runs.back()->size() > 0) {
+            highest = std::max(highest, runs.back()->levels()[runs.back()->size() - 1]);
+        }
+    }
+    auto countAbove = [&](uint64_t level) {
+        size_t count = 0;
+        for (const auto& run : runs) {
+            count += countAtOrAbove(*run, level, result.bytesRead_);
+        }
+        return count;
+    };
+
+    // The exact cutoff: the highest level with at least topCount Players at or above it
+    uint64_t low = 0;
+    uint64_t high = highest;
+    while (low < high) {
+        uint64_t mid = low + (high - low + 1) / 2;
+        if (countAbove(mid) >= topCount) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    uint64_t cutoff = low;
+    size_t skipEqual = countAbove(cutoff) - topCount; // Surplus Players tied at the cutoff
+
+    // Merge the runs in ascending order from the cutoff, dropping surplus ties
+    using Cursor = std::pair<uint64_t, size_t>; // (level, run)
+    std::vector<size_t> positions(runs.size());
+    std::vector<Cursor> heap;
+    for (size_t r = 0; r < runs.size(); ++r) {
+        positions[r] = runs[r]->size() - countAtOrAbove(*runs[r], cutoff, result.bytesRead_);
+        if (positions[r] < runs[r]->size()) {
+            heap.emplace_back(runs[r]->levels()[positions[r]], r);
+        }
+    }
+    std::make_heap(heap.begin(), heap.end(), std::greater<Cursor>());
+
+    // The merge state: run handles, cursors & the heap
+    result.peakMemory_ = std::max(result.peakMemory_, runs.capacity() * (sizeof(runs[0]) + sizeof(PlayerFile))
+            + positions.capacity() * sizeof(size_t) + heap.capacity() * sizeof(Cursor));
+
+    // Named like the runs, so concurrent calls never share a default output
+    result.outputPath_ = options.outputPath_;
+    if (result.outputPath_.empty()) {
+        result.outputPath_ = options.spillDirectory_ + "/external-top-" + std::to_string(::getpid()) + "-"
+            + std::to_string(spillId) + ".plr";
+    }
+    PlayerFileWriter writer(result.outputPath_, topCount);
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<Cursor>());
+        size_t r = heap.back().second;
+        heap.pop_back();
+
+        const PlayerFile& run = *runs[r];
+        size_t row = positions[r]++;
+        result.bytesRead_ += sizeof(uint64_t); // The level, read once for the heap
+        if (skipEqual > 0 && run.levels()[row] == cutoff) {
+            skipEqual--;
+        } else {
+            // The id, the name's two offsets & the name itself
+            Player player = run.player(row);
+            result.bytesRead_ += 3 * sizeof(uint64_t) + player.name_.size();
+            writer.append(player);
+        }
+        if (positions[r] < run.size()) {
+            heap.emplace_back(run.levels()[positions[r]], r);
+            std::push_heap(heap.begin(), heap.end(), std::greater<Cursor>());
+        }
+    }
+    writer.finish();
+    result.bytesWritten_ += writer.bytesWritten();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    result.ranking_.elapsed_ = std::chrono::duration<double, std::milli>(end - start).count();
+    return result;
+}
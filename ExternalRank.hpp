@@ -0,0 +1,86 @@
+#pragma once
+#include "Leaderboard.hpp"
+#include "PlayerStream.hpp"
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Limits & locations for Offline::externalRank().
+ *
+ * - memoryBudget_   -> The cap, in bytes, on the engine's own structures:
+ *                      buffered Players (sizeof(Player) + name bytes each)
+ *                      plus the fence column, held to half the budget, &
+ *                      the merge's run handles, cursors & heap. It excludes
+ *                      vector growth slack, the PlayerFileWriter buffers
+ *                      (about 1.5 MB plus the names of a batch) & the
+ *                      mapped runs, which live in the page cache.
+ * - spillDirectory_ -> Where sorted runs are written while ranking; they are
+ *                      removed before the engine returns
+ * - outputPath_     -> Where the ranking is written (as a PlayerFile) if it
+ *                      does not fit in memory; defaults to a name unique to
+ *                      the process & call, "<spillDirectory_>/external-top-
+ *                      <pid>-<call>.plr", so concurrent calls do not clash
+ */
+struct ExternalRankingOptions {
+    size_t memoryBudget_ = size_t(256) << 20;
+    std::string spillDirectory_ = "/tmp";
+    std::string outputPath_;
+};
+
+/**
+ * @brief The outcome of Offline::externalRank().
+ *
+ * - ranking_      -> The ranking, if it fit within the memory budget. Otherwise
+ *                    its top_ is empty & the ranking is in outputPath_.
+ *                    elapsed_ covers the whole call, reading included.
+ * - outputPath_   -> The PlayerFile holding the ranking in ascending order, or
+ *                    empty if the ranking is in ranking_
+ * - topCount_     -> The number of Players ranked, ceil(N / 10)
+ * - runs_         -> The number of sorted runs spilled to disk
+ * - bytesWritten_ -> Bytes written to spill runs & the output file
+ * - bytesRead_    -> Bytes of the mapped spill runs the engine reads: 8 per
+ *                    level probed by the binary searches & per level merged,
+ *                    plus the id, name offsets & name of every Player kept.
+ *                    The page faults behind them may read more from disk.
+ * - peakMemory_   -> The most bytes held at once by the structures
+ *                    memoryBudget_ covers
+ */
+struct ExternalRankingResult {
+    RankingResult ranking_;
+    std::string outputPath_;
+    size_t topCount_ = 0;
+    size_t runs_ = 0;
+    size_t bytesWritten_ = 0;
+    size_t bytesRead_ = 0;
+    size_t peakMemory_ = 0;
+};
+
+namespace Offline {
+/**
+ * @brief Selects & sorts the top 10% of a stream of Players too large to hold
+ *        in memory, within a fixed memory budget.
+ *
+ * Players are buffered in chunks of up to half the budget. Every Player at
+ * or below the running cutoff is dropped on arrival.
+ * 1) While the top 10% fits in memory, each full chunk is cut down to the
+ *    ceil(N / 10) best Players with a selection, raising the cutoff.
+ * 2) Once it does not, each chunk is sorted & spilled as a run (a PlayerFile).
+ *    The cutoff is raised from "fences" sampled from every run: each fence
+ *    certifies a fixed number of spilled Players at or above its level.
+ *
+ * After the stream is exhausted, the exact cutoff over the runs is found by
+ * binary searching the level domain (each probe binary-searches every run's
+ * mapped level column). The runs are then merged in ascending order,
+ * keeping only the Players at or above it, into the output file.
+ *
+ * @param stream A stream providing Player objects
+ * @param options The memory budget & file locations
+ * @return An ExternalRankingResult holding the ranking, or naming the file
+ *      it was written to, plus the I/O volume used
+ *
+ * @throws std::runtime_error if a spill or output file cannot be written.
+ * @post All elements of the stream are read until there are none remaining.
+ */
+ExternalRankingResult externalRank(PlayerStream& stream, const ExternalRankingOptions& options = {});
+}
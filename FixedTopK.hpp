@@ -0,0 +1,241 @@
+#pragma once
+#include "Leaderboard.hpp"
+#include "Player.hpp"
+#include "PlayerStream.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A top-K leaderboard whose capacity K is fixed at compile time.
+ *
+ * All storage lives inside the object (std::array), so a FixedTopK on the
+ * stack ranks without touching the heap. Levels are kept sorted in a small
+ * array alongside the slot of the Player holding each level, so accepting a
+ * Player shifts a few integers & moves exactly one Player (into the slot of
+ * the one it evicts).
+ *
+ * For K <= UNROLL_LIMIT the rank search & shift are fully unrolled over the
+ * whole array with conditional selects instead of branches; larger boards
+ * binary-search & shift with memmove.
+ *
+ * Acceptance matches Online::rankIncoming(): once full, a Player enters only
+ * if its level is strictly greater than cutoff(), & evicts the minimum.
+ *
+ * @example
+ *   FixedTopK<10> board;
+ *   for (const Player& player : players) board.push(player);
+ *   board[0]      -> the 10th best Player
+ *   board[9]      -> the best Player
+ */
+template <size_t K>
+class FixedTopK {
+    static_assert(K > 0, "FixedTopK needs a capacity of at least one");
+
+public:
+    static constexpr size_t UNROLL_LIMIT = 32;
+
+private:
+    std::array<size_t, K> levels_; // Ascending over [0, size_)
+    std::array<size_t, K> slots_; // slots_[i] holds the Player at levels_[i]
+    std::array<Player, K> players_;
+    size_t size_;
+
+    template <size_t... I>
+    size_t countBelow(size_t level, std::index_sequence<I...>) const {
+        return ((levels_[I] < level) + ...);
+    }
+
+    template <size_t... I>
+    void shiftDown(size_t rank, std::index_sequence<I...>) {
+        ((levels_[I] = I + 1 < rank ? levels_[I + 1] : levels_[I],
+             slots_[I] = I + 1 < rank ? slots_[I + 1] : slots_[I]),
+            ...);
+    }
+
+    /**
+     * @brief Returns the number of held levels strictly below <level>.
+     * @pre The board is full.
+     */
+    size_t rankOf(size_t level) const {
+        if constexpr (K <= UNROLL_LIMIT) {
+            return countBelow(level, std::make_index_sequence<K>());
+        } else {
+            return std::lower_bound(levels_.begin(), levels_.end(), level) - levels_.begin();
+        }
+    }
+
+    /**
+     * @brief Drops levels_[0] & moves [1, rank) down one place.
+     */
+    void evictBelow(size_t rank) {
+        if constexpr (K <= UNROLL_LIMIT) {
+            shiftDown(rank, std::make_index_sequence<K - 1>());
+        } else {
+            std::copy(levels_.begin() + 1, levels_.begin() + rank, levels_.begin());
+            std::copy(slots_.begin() + 1, slots_.begin() + rank, slots_.begin());
+        }
+    }
+
+public:
+    FixedTopK()
+        : size_ { 0 }
+    {
+    }
+
+    /**
+     * @brief Offers a Player to the board.
+     *
+     * @param player The Player, copied (or moved, if an rvalue) only if it is accepted
+     * @return Whether the Player was accepted
+     */
+    template <typename P>
+    bool push(P&& player) {
+        size_t level = player.level_;
+
+        if (size_ < K) {
+            // Filling: insert the new level into the sorted prefix
+            size_t rank = std::lower_bound(levels_.begin(), levels_.begin() + size_, level) - levels_.begin();
+            std::copy_backward(levels_.begin() + rank, levels_.begin() + size_, levels_.begin() + size_ + 1);
+            std::copy_backward(slots_.begin() + rank, slots_.begin() + size_, slots_.begin() + size_ + 1);
+            levels_[rank] = level;
+            slots_[rank] = size_;
+            players_[size_] = std::forward<P>(player);
+            size_++;
+            return true;
+        }
+
+        if (level <= levels_[0]) {
+            return false;
+        }
+
+        // The evicted minimum's slot receives the new Player
+        size_t slot = slots_[0];
+        size_t rank = rankOf(level);
+        evictBelow(rank);
+        levels_[rank - 1] = level;
+        slots_[rank - 1] = slot;
+        players_[slot] = std::forward<P>(player);
+        return true;
+    }
+
+    /**
+     * @brief Returns the number of Players held, at most K.
+     */
+    size_t size() const { return size_; }
+
+    /**
+     * @brief Returns whether the board holds K Players.
+     */
+    bool full() const { return size_ == K; }
+
+    /**
+     * @brief Returns the minimum level on the board.
+     * @pre size() > 0
+     */
+    size_t cutoff() const { return levels_[0]; }
+
+    /**
+     * @brief Returns the <i>-th lowest Player on the board.
+     * @pre i < size()
+     */
+    const Player& operator[](size_t i) const { return players_[slots_[i]]; }
+
+    /**
+     * @brief Returns the held Players, sorted in ascending order by level.
+     */
+    std::vector<Player> top() const {
+        std::vector<Player> top;
+        top.reserve(size_);
+        for (size_t i = 0; i < size_; ++i) {
+            top.push_back((*this)[i]);
+        }
+        return top;
+    }
+};
+
+namespace Online {
+/**
+ * @brief A rankIncoming() whose reporting interval, & so leaderboard size, is
+ * the compile-time constant K.
+ *
+ * The board lives on the stack; the only allocations are the returned
+ * RankingResult's. Streams providing `nextPlayerRef()` are read by
+ * reference, so rejected Players are never copied.
+ *
+ * @return A RankingResult identical in top_ levels & cutoffs_ to rankIncoming(stream, K)
+ * @post All elements of the stream are read until there are none remaining.
+ */
+template <size_t K, typename Stream>
+RankingResult rankIncomingFixed(Stream& stream) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    FixedTopK<K> board;
+    std::unordered_map<size_t, size_t> cutoffs;
+    size_t total = stream.remaining();
+    cutoffs.reserve(total / K + 1);
+
+    for (size_t playerCount = 1; playerCount <= total; ++playerCount) {
+        if constexpr (has_player_ref<Stream>::value) {
+            board.push(stream.nextPlayerRef());
+        } else {
+            board.push(stream.nextPlayer());
+        }
+
+        // Record cutoff at each reporting interval
+        if (playerCount % K == 0) {
+            cutoffs[playerCount] = board.cutoff();
+        }
+    }
+
+    // Record final cutoff if not already recorded
+    if (total % K != 0) {
+        cutoffs[total] = board.cutoff();
+    }
+
+    std::vector<Player> top = board.top();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    return RankingResult(std::move(top), std::move(cutoffs), elapsed);
+}
+}
+
+namespace Offline {
+/**
+ * @brief Selects the top K Players of [first, last) with a stack-resident
+ * FixedTopK, without modifying the range.
+ *
+ * @return A RankingResult whose top_ holds the min(K, N) highest leveled
+ *      Players in ascending order, & whose cutoffs_ is empty.
+ */
+template <size_t K, typename ForwardIt>
+RankingResult fixedTopRank(ForwardIt first, ForwardIt last) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    FixedTopK<K> board;
+    for (; first != last; ++first) {
+        board.push(*first);
+    }
+    std::vector<Player> top = board.top();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    return RankingResult(std::move(top), {}, elapsed);
+}
+
+/**
+ * @brief A fixedTopRank() over a whole vector.
+ */
+template <size_t K>
+RankingResult fixedTopRank(const std::vector<Player>& players) {
+    return fixedTopRank<K>(players.begin(), players.end());
+}
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "Player.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * @brief Work counters reported by an instrumented ranking call.
+ *
+ * - comparisons_  -> Player comparisons, including those made inside STL algorithms
+ * - moves_        -> Players copied or moved by the engine itself
+ *                    (element moves inside STL algorithms are not visible)
+ * - swaps_        -> Swaps performed while percolating in replaceMin()
+ * - siftDepth_    -> Total levels descended by replaceMin() percolations
+ * - maxSiftDepth_ -> Deepest single replaceMin() percolation
+ * - allocations_  -> Buffer (re)allocations made by the engine
+ */
+struct RankingStats {
+    size_t comparisons_ = 0;
+    size_t moves_ = 0;
+    size_t swaps_ = 0;
+    size_t siftDepth_ = 0;
+    size_t maxSiftDepth_ = 0;
+    size_t allocations_ = 0;
+};
+
+/**
+ * @brief The instrumentation policy used in production: every hook is an
+ * empty inline function, so instrumented engines compile to exactly the
+ * same code as uninstrumented ones.
+ */
+struct NullInstrumentation {
+    static constexpr bool enabled = false;
+
+    void compare() { }
+    void move(size_t = 1) { }
+    void swap() { }
+    void sift(size_t) { }
+    void allocate() { }
+    RankingStats stats() const { return {}; }
+};
+
+/**
+ * @brief An instrumentation policy tallying every hook into a RankingStats.
+ */
+struct CountingInstrumentation {
+    static constexpr bool enabled = true;
+    RankingStats stats_;
+
+    void compare() { stats_.comparisons_++; }
+    void move(size_t count = 1) { stats_.moves_ += count; }
+    void swap() { stats_.swaps_++; }
+    void sift(size_t depth)
+    {
+        stats_.siftDepth_ += depth;
+        stats_.maxSiftDepth_ = std::max(stats_.maxSiftDepth_, depth);
+    }
+    void allocate() { stats_.allocations_++; }
+    RankingStats stats() const { return stats_; }
+};
+
+/**
+ * @brief Wraps a Player comparator so every comparison is reported to an
+ * instrumentation policy. Use it to count comparisons made inside STL
+ * algorithms such as std::nth_element() or std::make_heap().
+ */
+template <typename Compare, typename Instrumentation>
+struct InstrumentedCompare {
+    Instrumentation* instrumentation_;
+    Compare compare_;
+
+    bool operator()(const Player& lhs, const Player& rhs) const
+    {
+        instrumentation_->compare();
+        return compare_(lhs, rhs);
+    }
+};
+
+/**
+ * @brief Returns <compare> wrapped to report to <instrumentation>.
+ */
+template <typename Compare, typename Instrumentation>
+InstrumentedCompare<Compare, Instrumentation> instrument(Compare compare, Instrumentation& instrumentation)
+{
+    return InstrumentedCompare<Compare, Instrumentation> { &instrumentation, compare };
+}
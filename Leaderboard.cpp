@@ -1,6 +1,13 @@
 #include "Leaderboard.hpp"
+#include "BlockSort.hpp"
+#include "CsvRoster.hpp"
+#include "LevelIndex.hpp"
+#include "LoserTree.hpp"
+#include "PlayerFile.hpp"
 #include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <thread>
 
 /**
  * @brief Constructor for RankingResult with top players, cutoffs, and elapsed time.
@@ -19,6 +26,72 @@ RankingResult::RankingResult(const std::vector<Player>& top, const std::unordere
 {
 }
 
+/**
+ * @brief Constructor for RankingResult taking ownership of the top players &
+ * cutoffs, which are moved rather than copied.
+ */
+RankingResult::RankingResult(std::vector<Player>&& top, std::unordered_map<size_t, size_t>&& cutoffs, double elapsed)
+    : top_ { std::move(top) }
+    , cutoffs_ { std::move(cutoffs) }
+    , elapsed_ { elapsed }
+{
+}
+
+/**
+ * @brief Combines partial rankings into the top <k> of their union with a
+ *        k-way loser tree merge.
+ */
+RankingResult RankingResult::merge(const std::vector<RankingResult>& parts, size_t k) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Each part is consumed from its highest level down
+    using Reversed = std::vector<Player>::const_reverse_iterator;
+    std::vector<Merge::Run<Reversed>> runs;
+    size_t totalPlayers = 0;
+    for (const RankingResult& part : parts) {
+        runs.emplace_back(part.top_.rbegin(), part.top_.rend());
+        totalPlayers += part.top_.size();
+    }
+
+    std::vector<Player> topPlayers;
+    topPlayers.reserve(std::min(k, totalPlayers));
+    Merge::mergeRuns(runs, std::back_inserter(topPlayers), k, [](const Player& player) { return player.level_; }, std::greater<>());
+    std::reverse(topPlayers.begin(), topPlayers.end());
+
+    // Only the final milestone of every stream lines up with the others
+    std::unordered_map<size_t, size_t> cutoffs;
+    bool milestones = !parts.empty() && !topPlayers.empty();
+    size_t finalCount = 0;
+    for (const RankingResult& part : parts) {
+        if (part.cutoffs_.empty()) {
+            milestones = false;
+            break;
+        }
+        size_t count = 0;
+        for (const auto& [milestone, level] : part.cutoffs_) {
+            count = std::max(count, milestone);
+        }
+        finalCount += count;
+    }
+    if (milestones) {
+        cutoffs[finalCount] = topPlayers.front().level_;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+    return RankingResult(std::move(topPlayers), std::move(cutoffs), elapsed);
+}
+
+/**
+ * @brief Constructs an empty result allocating from <resource>.
+ */
+PmrRankingResult::PmrRankingResult(std::pmr::memory_resource* resource)
+    : top_ { resource }
+    , cutoffs_ { resource }
+    , elapsed_ { 0 }
+{
+}
+
 /**
  * @brief Uses a mixture of quickselect/quicksort to
  *        select and sort the top 10% of players with O(log N) memory
@@ -33,26 +106,39 @@ RankingResult::RankingResult(const std::vector<Player>& top, const std::unordere
  * @post The order of the parameter vector is modified.
  */
 RankingResult Offline::quickSelectRank(std::vector<Player>& players) {
+    NullInstrumentation none;
+    return quickSelectRank(players, none);
+}
+
+template <typename Instrumentation>
+RankingResult Offline::quickSelectRank(std::vector<Player>& players, Instrumentation& instrumentation) {
     auto start = std::chrono::high_resolution_clock::now();
 
     size_t totalPlayers = players.size();
     size_t topCount = (totalPlayers + 9) / 10; // Ceiling of 10%
 
     // Quickselect to find the topCount-th largest element
-    std::nth_element(players.begin(), players.end() - topCount, players.end());
+    std::nth_element(players.begin(), players.end() - topCount, players.end(), instrument(std::less<Player>(), instrumentation));
 
     // Extract the top 10% players
     std::vector<Player> topPlayers(players.end() - topCount, players.end());
+    instrumentation.allocate();
+    instrumentation.move(topCount);
 
     // Sort the top players in ascending order
-    std::sort(topPlayers.begin(), topPlayers.end());
+    std::sort(topPlayers.begin(), topPlayers.end(), instrument(std::less<Player>(), instrumentation));
 
     auto end = std::chrono::high_resolution_clock::now();
     double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
 
-    return RankingResult(topPlayers, {}, elapsed);
+    RankingResult result(std::move(topPlayers), {}, elapsed);
+    result.stats_ = instrumentation.stats();
+    return result;
 }
 
+template RankingResult Offline::quickSelectRank(std::vector<Player>&, NullInstrumentation&);
+template RankingResult Offline::quickSelectRank(std::vector<Player>&, CountingInstrumentation&);
+
 /**
  * @brief Uses an early-stopping version of heapsort to
  *        select and sort the top 10% of players in-place
@@ -67,28 +153,510 @@ RankingResult Offline::quickSelectRank(std::vector<Player>& players) {
  * @post The order of the parameter vector is modified.
  */
 RankingResult Offline::heapRank(std::vector<Player>& players) {
+    NullInstrumentation none;
+    return heapRank(players, none);
+}
+
+template <typename Instrumentation>
+RankingResult Offline::heapRank(std::vector<Player>& players, Instrumentation& instrumentation) {
     auto start = std::chrono::high_resolution_clock::now();
 
     size_t totalPlayers = players.size();
     size_t topCount = (totalPlayers + 9) / 10; // Ceiling of 10%
+    auto less = instrument(std::less<Player>(), instrumentation);
 
     // Build a max heap
-    std::make_heap(players.begin(), players.end());
+    std::make_heap(players.begin(), players.end(), less);
 
     // Extract the topCount largest elements
     std::vector<Player> topPlayers;
+    topPlayers.reserve(topCount);
+    instrumentation.allocate();
     for (size_t i = 0; i < topCount; ++i) {
-        std::pop_heap(players.begin(), players.end() - i);
+        std::pop_heap(players.begin(), players.end() - i, less);
+        size_t capacity = topPlayers.capacity();
         topPlayers.push_back(players[players.size() - 1 - i]);
+        instrumentation.move();
+        if (topPlayers.capacity() != capacity) {
+            instrumentation.allocate();
+        }
     }
 
     // Sort the top players in ascending order
+    std::sort(topPlayers.begin(), topPlayers.end(), less);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    RankingResult result(std::move(topPlayers), {}, elapsed);
+    result.stats_ = instrumentation.stats();
+    return result;
+}
+
+template RankingResult Offline::heapRank(std::vector<Player>&, NullInstrumentation&);
+template RankingResult Offline::heapRank(std::vector<Player>&, CountingInstrumentation&);
+
+/**
+ * @brief A quickSelectRank() whose result is allocated from <resource>.
+ */
+PmrRankingResult Offline::quickSelectRank(std::vector<Player>& players, std::pmr::memory_resource* resource) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    PmrRankingResult result(resource);
+    size_t topCount = (players.size() + 9) / 10; // Ceiling of 10%
+
+    std::nth_element(players.begin(), players.end() - topCount, players.end());
+    result.top_.assign(players.end() - topCount, players.end());
+    std::sort(result.top_.begin(), result.top_.end());
+
+    auto end = std::chrono::high_resolution_clock::now();
+    result.elapsed_ = std::chrono::duration<double, std::milli>(end - start).count();
+    return result;
+}
+
+/**
+ * @brief A heapRank() whose result is allocated from <resource>.
+ */
+PmrRankingResult Offline::heapRank(std::vector<Player>& players, std::pmr::memory_resource* resource) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    PmrRankingResult result(resource);
+    size_t topCount = (players.size() + 9) / 10; // Ceiling of 10%
+
+    std::make_heap(players.begin(), players.end());
+    result.top_.reserve(topCount);
+    for (size_t i = 0; i < topCount; ++i) {
+        std::pop_heap(players.begin(), players.end() - i);
+        result.top_.push_back(players[players.size() - 1 - i]);
+    }
+    std::sort(result.top_.begin(), result.top_.end());
+
+    auto end = std::chrono::high_resolution_clock::now();
+    result.elapsed_ = std::chrono::duration<double, std::milli>(end - start).count();
+    return result;
+}
+
+/**
+ * @brief A quickSelectRank() that sorts the top 10% in place at the tail of
+ * <players> & returns a view of it.
+ */
+RankingView Offline::quickSelectRankInPlace(std::vector<Player>& players) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    size_t topCount = (players.size() + 9) / 10; // Ceiling of 10%
+    auto first = players.end() - topCount;
+
+    std::nth_element(players.begin(), first, players.end());
+    std::sort(first, players.end());
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+    return RankingView { players.data() + players.size() - topCount, topCount, nullptr, 0, elapsed };
+}
+
+/**
+ * @brief A heapRank() that leaves the top 10% in place at the tail of
+ * <players> & returns a view of it.
+ *
+ * Each pop_heap() moves the next largest Player to the end of the shrinking
+ * heap, so the tail is already in ascending order & needs no final sort.
+ */
+RankingView Offline::heapRankInPlace(std::vector<Player>& players) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    size_t topCount = (players.size() + 9) / 10; // Ceiling of 10%
+
+    std::make_heap(players.begin(), players.end());
+    for (size_t i = 0; i < topCount; ++i) {
+        std::pop_heap(players.begin(), players.end() - i);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+    return RankingView { players.data() + players.size() - topCount, topCount, nullptr, 0, elapsed };
+}
+
+/**
+ * @brief Uses BlockSort's introselect/introsort to select and sort the top
+ *        10% of players with O(log N) memory
+ *        (excluding the returned RankingResult vector)
+ *
+ * @post The order of the parameter vector is modified.
+ */
+RankingResult Offline::blockQuickSelectRank(std::vector<Player>& players) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    size_t totalPlayers = players.size();
+    size_t topCount = (totalPlayers + 9) / 10; // Ceiling of 10%
+    auto level = [](const Player& player) { return player.level_; };
+
+    // Block-partitioned quickselect to find the topCount-th largest element
+    BlockSort::select(players.begin(), players.end() - topCount, players.end(), level);
+
+    // Extract the top 10% players
+    std::vector<Player> topPlayers(players.end() - topCount, players.end());
+
+    // Sort the top players in ascending order
+    BlockSort::sort(topPlayers.begin(), topPlayers.end(), level);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    return RankingResult(std::move(topPlayers), {}, elapsed);
+}
+
+namespace {
+constexpr size_t SAMPLE_SIZE = 4096;
+constexpr size_t SAMPLE_MIN_PLAYERS = 16 * SAMPLE_SIZE;
+constexpr size_t FILTER_BLOCK = 256;
+
+uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Returns a level at or below the <topCount>-th largest of <players>
+ * with overwhelming probability, estimated from a fixed-seed sample.
+ */
+size_t sampleLowerBracket(const std::vector<Player>& players, size_t topCount) {
+    size_t n = players.size();
+    std::vector<size_t> sample(SAMPLE_SIZE);
+    for (size_t i = 0; i < SAMPLE_SIZE; ++i) {
+        uint64_t index = static_cast<uint64_t>((static_cast<unsigned __int128>(splitmix64(i)) * n) >> 64);
+        sample[i] = players[index].level_;
+    }
+
+    // The cutoff's rank in the sample is binomial; step 5 standard deviations below it
+    double below = 1.0 - static_cast<double>(topCount) / n;
+    double deviation = std::sqrt(SAMPLE_SIZE * below * (1.0 - below));
+    double rank = std::floor(SAMPLE_SIZE * below - 5.0 * deviation - 1.0);
+    if (rank < 0) {
+        return 0;
+    }
+    auto nth = sample.begin() + static_cast<size_t>(rank);
+    std::nth_element(sample.begin(), nth, sample.end());
+    return *nth;
+}
+
+/**
+ * @brief Appends the index of every Player in [first, last) with a level of
+ * at least <bracket> to <out>. Indices are written unconditionally into a
+ * block buffer & only the cursor advances on a match, so the scan has no
+ * data-dependent branches.
+ */
+void filterAtOrAbove(const std::vector<Player>& players, size_t first, size_t last, size_t bracket, std::vector<size_t>& out) {
+    size_t block[FILTER_BLOCK];
+    for (size_t begin = first; begin < last; begin += FILTER_BLOCK) {
+        size_t end = std::min(last, begin + FILTER_BLOCK);
+        size_t count = 0;
+        for (size_t i = begin; i < end; ++i) {
+            block[count] = i;
+            count += players[i].level_ >= bracket;
+        }
+        out.insert(out.end(), block, block + count);
+    }
+}
+}
+
+/**
+ * @brief Selects & sorts the top 10% of players from a sampled cutoff
+ *        estimate & a single filtering pass, without modifying the input.
+ */
+RankingResult Offline::sampleSelectRank(const std::vector<Player>& players, size_t threads) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    size_t totalPlayers = players.size();
+    size_t topCount = (totalPlayers + 9) / 10; // Ceiling of 10%
+
+    std::vector<Player> topPlayers;
+    bool sampled = totalPlayers >= SAMPLE_MIN_PLAYERS;
+    if (sampled) {
+        size_t bracket = sampleLowerBracket(players, topCount);
+
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threads = std::max<size_t>(1, std::min(threads, totalPlayers / SAMPLE_MIN_PLAYERS));
+
+        // Each thread filters its own slice into its own candidate buffer
+        std::vector<std::vector<size_t>> candidates(threads);
+        auto filter = [&](size_t t) {
+            candidates[t].reserve(2 * topCount / threads + FILTER_BLOCK);
+            filterAtOrAbove(players, totalPlayers * t / threads, totalPlayers * (t + 1) / threads, bracket, candidates[t]);
+        };
+        std::vector<std::thread> workers;
+        for (size_t t = 1; t < threads; ++t) {
+            workers.emplace_back(filter, t);
+        }
+        filter(0);
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        // Exact select & sort over the candidates alone
+        size_t candidateCount = 0;
+        for (const std::vector<size_t>& slice : candidates) {
+            candidateCount += slice.size();
+        }
+        std::vector<std::pair<size_t, size_t>> levels;
+        levels.reserve(candidateCount);
+        for (const std::vector<size_t>& slice : candidates) {
+            for (size_t index : slice) {
+                levels.emplace_back(players[index].level_, index);
+            }
+        }
+        sampled = levels.size() >= topCount;
+        if (sampled) {
+            auto cut = levels.end() - topCount;
+            std::nth_element(levels.begin(), cut, levels.end());
+            topPlayers.reserve(topCount);
+
+            if (threads == 1) {
+                std::sort(cut, levels.end());
+                for (; cut != levels.end(); ++cut) {
+                    topPlayers.push_back(players[cut->second]);
+                }
+            } else {
+                // Each thread sorts a slice of the winners, then all merge in parallel
+                using LevelIt = std::vector<std::pair<size_t, size_t>>::iterator;
+                std::vector<Merge::Run<LevelIt>> runs;
+                for (size_t t = 0; t < threads; ++t) {
+                    runs.emplace_back(cut + topCount * t / threads, cut + topCount * (t + 1) / threads);
+                }
+                auto sortRun = [&](size_t t) { std::sort(runs[t].first, runs[t].second); };
+                std::vector<std::thread> sorters;
+                for (size_t t = 1; t < threads; ++t) {
+                    sorters.emplace_back(sortRun, t);
+                }
+                sortRun(0);
+                for (std::thread& sorter : sorters) {
+                    sorter.join();
+                }
+
+                std::vector<std::pair<size_t, size_t>> sorted(topCount);
+                Merge::parallelMergeRuns(runs, sorted.begin(), topCount, threads, [](const std::pair<size_t, size_t>& level) { return level; });
+                for (const auto& level : sorted) {
+                    topPlayers.push_back(players[level.second]);
+                }
+            }
+        }
+    }
+
+    if (!sampled) {
+        // Too small to sample, or the bracket missed: rank a copy exactly
+        std::vector<Player> copy(players);
+        topPlayers = Offline::quickSelectRank(copy).top_;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    return RankingResult(std::move(topPlayers), {}, elapsed);
+}
+
+namespace {
+/**
+ * @brief Materializes the <topCount> Players of a roster whose level is at
+ * least <threshold>, preferring those strictly above it, in ascending order.
+ *
+ * @param roster Any columnar roster exposing levelColumns() & player(row)
+ * @pre At least <topCount> rows have a level >= threshold.
+ */
+template <typename Roster>
+std::vector<Player> collectAtOrAbove(const Roster& roster, size_t threshold, size_t topCount) {
+    std::vector<size_t> above;
+    std::vector<size_t> equal;
+    above.reserve(topCount);
+
+    for (const LevelColumn& column : roster.levelColumns()) {
+        for (size_t i = 0; i < column.size_; ++i) {
+            if (column.levels_[i] > threshold) {
+                above.push_back(column.firstRow_ + i);
+            } else if (column.levels_[i] == threshold && equal.size() < topCount) {
+                equal.push_back(column.firstRow_ + i);
+            }
+        }
+    }
+    equal.resize(topCount - above.size());
+
+    std::vector<Player> topPlayers;
+    topPlayers.reserve(topCount);
+    for (size_t row : equal) {
+        topPlayers.push_back(roster.player(row));
+    }
+    for (size_t row : above) {
+        topPlayers.push_back(roster.player(row));
+    }
+    std::sort(topPlayers.begin(), topPlayers.end());
+    return topPlayers;
+}
+
+/**
+ * @brief Selects the <topCount> highest leveled Players of a roster with a
+ * single SmallTopK pass over its level columns, in ascending order.
+ *
+ * @pre 0 < topCount <= SmallTopK::MAX_K
+ */
+template <typename Roster>
+std::vector<Player> smallSelectColumns(const Roster& roster, size_t topCount) {
+    SmallTopK board(topCount);
+    size_t rows[SmallTopK::MAX_K];
+
+    for (const LevelColumn& column : roster.levelColumns()) {
+        for (size_t i = 0; i < column.size_; ++i) {
+            size_t slot = board.push(column.levels_[i]);
+            if (slot != SmallTopK::REJECTED) {
+                rows[slot] = column.firstRow_ + i;
+            }
+        }
+    }
+
+    std::vector<Player> topPlayers;
+    topPlayers.reserve(board.size());
+    for (size_t i = 0; i < board.size(); ++i) {
+        topPlayers.push_back(roster.player(rows[board.slot(i)]));
+    }
+    return topPlayers;
+}
+
+/**
+ * @brief Quickselects the cutoff over a copy of a roster's level columns,
+ * then materializes only the top 10% of its Players.
+ */
+template <typename Roster>
+RankingResult quickSelectColumns(const Roster& roster) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    size_t totalPlayers = roster.size();
+    size_t topCount = (totalPlayers + 9) / 10; // Ceiling of 10%
+
+    std::vector<Player> topPlayers;
+    if (topCount > 0 && topCount <= SmallTopK::MAX_K) {
+        topPlayers = smallSelectColumns(roster, topCount);
+    } else if (topCount > 0) {
+        // Quickselect the cutoff level over the level columns alone
+        std::vector<uint64_t> levels;
+        levels.reserve(totalPlayers);
+        for (const LevelColumn& column : roster.levelColumns()) {
+            levels.insert(levels.end(), column.levels_, column.levels_ + column.size_);
+        }
+        std::nth_element(levels.begin(), levels.end() - topCount, levels.end());
+        topPlayers = collectAtOrAbove(roster, *(levels.end() - topCount), topCount);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    return RankingResult(std::move(topPlayers), {}, elapsed);
+}
+
+/**
+ * @brief Scans a roster's level columns in place, keeping a min-heap of the
+ * (level, row) pairs of the top 10%, then materializes only those Players.
+ */
+template <typename Roster>
+RankingResult heapSelectColumns(const Roster& roster) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    size_t totalPlayers = roster.size();
+    size_t topCount = (totalPlayers + 9) / 10; // Ceiling of 10%
+
+    if (topCount > 0 && topCount <= SmallTopK::MAX_K) {
+        std::vector<Player> topPlayers = smallSelectColumns(roster, topCount);
+
+        auto end = std::chrono::high_resolution_clock::now();
+        double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+        return RankingResult(std::move(topPlayers), {}, elapsed);
+    }
+
+    using Entry = std::pair<uint64_t, size_t>;
+    std::vector<Entry> heap;
+    heap.reserve(topCount);
+
+    for (const LevelColumn& column : roster.levelColumns()) {
+        for (size_t i = 0; i < column.size_; ++i) {
+            if (heap.size() < topCount) {
+                heap.emplace_back(column.levels_[i], column.firstRow_ + i);
+                std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+            } else if (column.levels_[i] > heap.front().first) {
+                std::pop_heap(heap.begin(), heap.end(), std::greater<Entry>());
+                heap.back() = Entry(column.levels_[i], column.firstRow_ + i);
+                std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+            }
+        }
+    }
+
+    std::vector<Player> topPlayers;
+    topPlayers.reserve(topCount);
+    for (const Entry& entry : heap) {
+        topPlayers.push_back(roster.player(entry.second));
+    }
     std::sort(topPlayers.begin(), topPlayers.end());
 
     auto end = std::chrono::high_resolution_clock::now();
     double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
 
-    return RankingResult(topPlayers, {}, elapsed);
+    return RankingResult(std::move(topPlayers), {}, elapsed);
+}
+}
+
+/**
+ * @brief A quickSelectRank() over a memory-mapped roster file.
+ *
+ * Selection runs over a copy of the mapped level column only; Players are
+ * materialized solely for the top 10%, so the file is never parsed in full.
+ *
+ * @param roster A mapped roster file (left unmodified)
+ * @return A Ranking Result identical in levels to quickSelectRank() over the
+ *         file's Players, with each Player's id_ populated.
+ */
+RankingResult Offline::quickSelectRank(const PlayerFile& roster) {
+    return quickSelectColumns(roster);
+}
+
+/**
+ * @brief A heapRank() over a memory-mapped roster file.
+ *
+ * Scans the mapped level column in place, keeping a min-heap of the
+ * (level, row) pairs of the top 10%, so no copy of the column is made.
+ *
+ * @param roster A mapped roster file (left unmodified)
+ * @return A Ranking Result identical in levels to heapRank() over the
+ *         file's Players, with each Player's id_ populated.
+ */
+RankingResult Offline::heapRank(const PlayerFile& roster) {
+    return heapSelectColumns(roster);
+}
+
+/**
+ * @brief A quickSelectRank() over a roster loaded by loadCsvRoster().
+ *
+ * Selection runs over a copy of the per-chunk level columns only;
+ * Players are materialized solely for the top 10%.
+ *
+ * @param roster A parsed roster (left unmodified)
+ * @return A Ranking Result identical in levels to quickSelectRank() over the
+ *         roster's Players, with each Player's id_ populated.
+ */
+RankingResult Offline::quickSelectRank(const CsvRoster& roster) {
+    return quickSelectColumns(roster);
+}
+
+/**
+ * @brief A heapRank() over a roster loaded by loadCsvRoster().
+ *
+ * Scans the per-chunk level columns in place, keeping a min-heap of the
+ * (level, row) pairs of the top 10%.
+ *
+ * @param roster A parsed roster (left unmodified)
+ * @return A Ranking Result identical in levels to heapRank() over the
+ *         roster's Players, with each Player's id_ populated.
+ */
+RankingResult Offline::heapRank(const CsvRoster& roster) {
+    return heapSelectColumns(roster);
 }
 
 /**
@@ -117,6 +685,12 @@ RankingResult Offline::heapRank(std::vector<Player>& players) {
  *   (ie. you may move it).
  */
 void Online::replaceMin(PlayerIt first, PlayerIt last, Player& target) {
+    NullInstrumentation none;
+    replaceMin(first, last, target, none);
+}
+
+template <typename Iterator, typename Instrumentation>
+void Online::replaceMin(Iterator first, Iterator last, Player& target, Instrumentation& instrumentation) {
     size_t heapSize = std::distance(first, last);
     if (heapSize == 0) {
         return; // Empty heap, nothing to replace
@@ -124,29 +698,45 @@ void Online::replaceMin(PlayerIt first, PlayerIt last, Player& target) {
 
     // Replace the root of the heap with the target
     *first = std::move(target);
+    instrumentation.move();
 
     // Percolate down to restore the min-heap property
     size_t index = 0;
+    size_t depth = 0;
     while (true) {
         size_t leftChildIdx = 2 * index + 1;
         size_t rightChildIdx = 2 * index + 2;
         size_t smallestIdx = index;
 
-        if (leftChildIdx < heapSize && *(first + leftChildIdx) < *(first + smallestIdx)) {
-            smallestIdx = leftChildIdx;
+        if (leftChildIdx < heapSize) {
+            instrumentation.compare();
+            if (*(first + leftChildIdx) < *(first + smallestIdx)) {
+                smallestIdx = leftChildIdx;
+            }
         }
-        if (rightChildIdx < heapSize && *(first + rightChildIdx) < *(first + smallestIdx)) {
-            smallestIdx = rightChildIdx;
+        if (rightChildIdx < heapSize) {
+            instrumentation.compare();
+            if (*(first + rightChildIdx) < *(first + smallestIdx)) {
+                smallestIdx = rightChildIdx;
+            }
         }
         if (smallestIdx == index) {
             break; // Heap property is restored
         }
 
         std::swap(*(first + index), *(first + smallestIdx));
+        instrumentation.swap();
         index = smallestIdx;
+        depth++;
     }
+    instrumentation.sift(depth);
 }
 
+template void Online::replaceMin(PlayerIt, PlayerIt, Player&, NullInstrumentation&);
+template void Online::replaceMin(PlayerIt, PlayerIt, Player&, CountingInstrumentation&);
+template void Online::replaceMin(PmrPlayerIt, PmrPlayerIt, Player&, NullInstrumentation&);
+template void Online::replaceMin(PmrPlayerIt, PmrPlayerIt, Player&, CountingInstrumentation&);
+
 /**
  * @brief Exhausts a stream of Players (ie. until there are none left) such that we:
  * 1) Maintain a running collection of the <reporting_interval> highest leveled players
@@ -179,51 +769,373 @@ void Online::replaceMin(PlayerIt first, PlayerIt last, Player& target) {
  * elapsed_ = 0.003 (Your runtime will vary based on hardware)
  */
 RankingResult Online::rankIncoming(PlayerStream& stream, const size_t& reporting_interval) {
-    auto start = std::chrono::high_resolution_clock::now();
+    NullInstrumentation none;
+    return rankIncoming(stream, reporting_interval, none);
+}
 
-    std::vector<Player> topPlayers;
-    std::unordered_map<size_t, size_t> cutoffs;
+template <typename Instrumentation>
+RankingResult Online::rankIncoming(PlayerStream& stream, const size_t& reporting_interval, Instrumentation& instrumentation) {
+    return Online::detail::rankIncomingCore([&stream]() { return stream.nextPlayer(); },
+        stream.remaining(), reporting_interval, instrumentation);
+}
+
+template RankingResult Online::rankIncoming(PlayerStream&, const size_t&, NullInstrumentation&);
+template RankingResult Online::rankIncoming(PlayerStream&, const size_t&, CountingInstrumentation&);
+
+/**
+ * @brief A rankIncoming() whose heap, & so its result, is allocated from <resource>.
+ */
+PmrRankingResult Online::rankIncoming(PlayerStream& stream, const size_t& reporting_interval, std::pmr::memory_resource* resource) {
+    PmrRankingResult result(resource);
+    NullInstrumentation none;
+    result.elapsed_ = Online::detail::ingestTop([&stream]() { return stream.nextPlayer(); },
+        stream.remaining(), reporting_interval, none, result.top_, result.cutoffs_);
+    return result;
+}
+
+/**
+ * @brief A rankIncoming() that also adds every Player's level to <index>.
+ *
+ * index.add() checks the level before touching any counter, so a throw
+ * leaves exactly the Players fetched before it indexed.
+ */
+RankingResult Online::rankIncoming(PlayerStream& stream, const size_t& reporting_interval, LevelIndex& index) {
+    auto fetch = [&stream, &index]() {
+        Player player = stream.nextPlayer();
+        index.add(player.level_);
+        return player;
+    };
+    return Online::detail::rankIncomingCore(fetch, stream.remaining(), reporting_interval);
+}
 
-    size_t playerCount = 0;
+/**
+ * @brief Constructs an empty ranker.
+ */
+Online::TopFractionRanker::TopFractionRanker()
+    : count_ { 0 }
+{
+}
 
-    // Initialize the min-heap with the first 'reporting_interval' players
-    while (playerCount < reporting_interval && stream.remaining() > 0) {
-        topPlayers.push_back(stream.nextPlayer());
-        playerCount++;
+/**
+ * @brief Adds a Player to the ranker, growing the capacity when needed.
+ *
+ * @param player The Player to add. It is moved into the ranker.
+ * @post winners_ holds the ceil(count() / 10) highest leveled Players seen.
+ */
+void Online::TopFractionRanker::push(Player player) {
+    count_++;
+
+    if (winners_.size() < capacity()) {
+        // Capacity grew: the larger of the new player & the best non-winner joins
+        if (!reservoir_.empty() && reservoir_.front() > player) {
+            std::pop_heap(reservoir_.begin(), reservoir_.end());
+            std::swap(reservoir_.back(), player);
+            std::push_heap(reservoir_.begin(), reservoir_.end());
+        }
+        winners_.push_back(std::move(player));
+        std::push_heap(winners_.begin(), winners_.end(), std::greater<Player>());
+        return;
     }
-    std::make_heap(topPlayers.begin(), topPlayers.end(), std::greater<Player>());
 
-    // Record the cutoff after the initial batch if applicable
-    if (playerCount == reporting_interval) {
-        cutoffs[playerCount] = topPlayers.front().level_;
+    if (player.level_ > winners_.front().level_) {
+        // Demote the current minimum, then percolate the new player into its slot
+        reservoir_.push_back(std::move(winners_.front()));
+        std::push_heap(reservoir_.begin(), reservoir_.end());
+        Online::replaceMin(winners_.begin(), winners_.end(), player);
+    } else {
+        reservoir_.push_back(std::move(player));
+        std::push_heap(reservoir_.begin(), reservoir_.end());
     }
+}
+
+/**
+ * @brief Returns the number of Players pushed so far.
+ */
+size_t Online::TopFractionRanker::count() const {
+    return count_;
+}
 
-    // Process remaining players in the stream
-    while (stream.remaining() > 0) {
-        Player next = stream.nextPlayer();
-        playerCount++;
+/**
+ * @brief Returns the current leaderboard capacity, ceil(count() / 10).
+ */
+size_t Online::TopFractionRanker::capacity() const {
+    return (count_ + 9) / 10; // Ceiling of 10%
+}
 
-        // If the new player has a higher level than the minimum in the heap
-        if (next.level_ > topPlayers.front().level_) {
-            Online::replaceMin(topPlayers.begin(), topPlayers.end(), next);
+/**
+ * @brief Returns the minimum level required to be on the leaderboard.
+ *
+ * @throws std::runtime_error if no Players have been pushed.
+ */
+size_t Online::TopFractionRanker::cutoff() const {
+    if (winners_.empty()) {
+        throw std::runtime_error("No players have been ranked.");
+    }
+    return winners_.front().level_;
+}
+
+/**
+ * @brief Returns the current leaderboard, sorted in ascending order by level.
+ *
+ * Matches the top_ of Offline::quickSelectRank() over every Player pushed so far.
+ */
+std::vector<Player> Online::TopFractionRanker::top() const {
+    std::vector<Player> topPlayers(winners_);
+    std::sort(topPlayers.begin(), topPlayers.end());
+    return topPlayers;
+}
+
+namespace {
+/**
+ * @brief The board of Online::rankTopFraction(), whose capacity grows with
+ * the number of Players pushed (see Online::detail::ingestBoard()).
+ */
+class TopFractionBoard {
+private:
+    std::vector<Player>& top_;
+    Online::TopFractionRanker ranker_;
+
+public:
+    explicit TopFractionBoard(std::vector<Player>& top)
+        : top_ { top }
+    {
+    }
+
+    void push(Player player) {
+        ranker_.push(std::move(player));
+    }
+
+    size_t milestone() const {
+        return ranker_.cutoff();
+    }
+
+    void finish() {
+        top_ = ranker_.top();
+    }
+};
+}
+
+/**
+ * @brief Exhausts a stream of Players (ie. until there are none left) such that we:
+ * 1) Maintain a running collection of the top 10% of players read so far
+ * 2) Record the Player level after reading every <reporting_interval> players
+ *    representing the minimum level required to be in the leaderboard at that point.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @return A RankingResult in which:
+ * - top_       -> Contains the top ceil(N / 10) Players read in the stream in
+ *                 sorted (least to greatest) order
+ * - cutoffs_   -> Maps player count milestones to minimum level required at that point
+ *                 including the minimum level after ALL players have been read
+ * - elapsed_   -> Contains the duration (ms) of the selection/sorting operation
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult Online::rankTopFraction(PlayerStream& stream, const size_t& reporting_interval) {
+    return Online::detail::rankIncomingCore<TopFractionBoard>([&stream]() { return stream.nextPlayer(); },
+        stream.remaining(), reporting_interval);
+}
+
+namespace {
+/**
+ * @brief Folds a buffer of candidates into a min-heap of <capacity> Players,
+ * keeping only the <capacity> highest leveled Players of both.
+ *
+ * @post heap is a min-heap of size min(capacity, heap.size() + buffer.size())
+ *       & buffer is empty.
+ */
+void foldBuffer(std::vector<Player>& heap, std::vector<Player>& buffer, size_t capacity) {
+    if (buffer.empty()) {
+        return;
+    }
+    std::move(buffer.begin(), buffer.end(), std::back_inserter(heap));
+    buffer.clear();
+
+    if (heap.size() > capacity) {
+        std::nth_element(heap.begin(), heap.end() - capacity, heap.end());
+        heap.erase(heap.begin(), heap.end() - capacity);
+    }
+    std::make_heap(heap.begin(), heap.end(), std::greater<Player>());
+}
+
+/**
+ * @brief The board of Online::rankIncomingAdaptive(): a rankIncoming() heap
+ * that buffers accepted Players between milestones while the acceptance
+ * rate is high (see Online::detail::ingestBoard()).
+ */
+class AdaptiveBoard {
+private:
+    std::vector<Player>& heap_;
+    std::vector<Player> buffer_;
+    size_t capacity_;
+    double threshold_;
+    bool buffered_;
+    size_t accepted_;
+
+public:
+    AdaptiveBoard(std::vector<Player>& heap, size_t capacity, double threshold)
+        : heap_ { heap }
+        , capacity_ { capacity }
+        , threshold_ { threshold }
+        , buffered_ { false }
+        , accepted_ { 0 }
+    {
+    }
+
+    void push(Player next) {
+        // Initialize the min-heap with the first <capacity> Players
+        if (heap_.size() < capacity_) {
+            heap_.push_back(std::move(next));
+            if (heap_.size() == capacity_) {
+                std::make_heap(heap_.begin(), heap_.end(), std::greater<Player>());
+            }
+            return;
         }
 
-        // Record cutoff at each reporting interval
-        if (playerCount % reporting_interval == 0) {
-            cutoffs[playerCount] = topPlayers.front().level_;
+        // The heap is only stale in buffered mode, & its minimum never decreases,
+        // so anything rejected here could never have made the leaderboard
+        if (next.level_ > heap_.front().level_) {
+            accepted_++;
+            if (buffered_) {
+                buffer_.push_back(std::move(next));
+            } else {
+                Online::replaceMin(heap_.begin(), heap_.end(), next);
+            }
         }
     }
 
-    // Record final cutoff if not already recorded
-    if (playerCount % reporting_interval != 0) {
-        cutoffs[playerCount] = topPlayers.front().level_;
+    size_t milestone() {
+        // A stream shorter than the capacity only reaches its final milestone
+        if (heap_.size() < capacity_) {
+            std::make_heap(heap_.begin(), heap_.end(), std::greater<Player>());
+            return heap_.front().level_;
+        }
+        foldBuffer(heap_, buffer_, capacity_);
+
+        // Reconsider the mode for the next interval
+        double rate = static_cast<double>(accepted_) / capacity_;
+        if (!buffered_ && rate > threshold_) {
+            buffered_ = true;
+            buffer_.reserve(capacity_);
+        } else if (buffered_ && rate < threshold_ / 2) {
+            buffered_ = false;
+        }
+        accepted_ = 0;
+        return heap_.front().level_;
     }
 
-    // Sort the top players in ascending order
-    std::sort(topPlayers.begin(), topPlayers.end());
+    void finish() {
+        foldBuffer(heap_, buffer_, capacity_);
+        std::sort(heap_.begin(), heap_.end());
+    }
+};
+}
+
+/**
+ * @brief An adaptive version of rankIncoming() for streams trending upwards.
+ *
+ * On ascending streams almost every Player beats the heap's minimum and pays
+ * a full replaceMin() percolation. This engine tracks the acceptance rate over
+ * each reporting interval and, once it exceeds <acceptance_threshold>, switches
+ * to a buffered mode: Players beating the (stale) cutoff are appended to a
+ * buffer, which is folded into the heap at every milestone with a single
+ * selection over heap + buffer. Since the buffer never holds more than
+ * <reporting_interval> Players, each fold costs O(reporting_interval), i.e.
+ * amortized O(1) per Player. It returns to heap mode once the acceptance
+ * rate falls below half the threshold.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @param acceptance_threshold The fraction of accepted Players in an interval
+ *        above which buffered mode is used
+ * @return A RankingResult identical in top_ levels & cutoffs_ to rankIncoming()
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult Online::rankIncomingAdaptive(PlayerStream& stream, const size_t& reporting_interval, double acceptance_threshold) {
+    return Online::detail::rankIncomingCore<AdaptiveBoard>([&stream]() { return stream.nextPlayer(); },
+        stream.remaining(), reporting_interval, reporting_interval, acceptance_threshold);
+}
+
+namespace {
+/**
+ * @brief Adapts a milestone vector to the map interface of
+ * Online::detail::ingestTop(), which assigns each milestone exactly once &
+ * in increasing order of count.
+ */
+struct MilestoneRecorder {
+    std::vector<Milestone>& milestones_;
+
+    void reserve(size_t count) { milestones_.reserve(count); }
+
+    size_t& operator[](size_t count) {
+        milestones_.push_back(Milestone { count, 0 });
+        return milestones_.back().level_;
+    }
+};
+}
+
+/**
+ * @brief Constructs a Ranker with no storage.
+ */
+Ranker::Ranker()
+    : elapsed_ { 0 }
+{
+}
+
+RankingView Ranker::view() const {
+    return RankingView { top_.data(), top_.size(), milestones_.data(), milestones_.size(), elapsed_ };
+}
+
+/**
+ * @brief Selects & sorts the top 10% of <players>, as Offline::quickSelectRank(),
+ * into the Ranker's storage.
+ */
+RankingView Ranker::rank(std::vector<Player>& players) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    size_t topCount = (players.size() + 9) / 10; // Ceiling of 10%
+    milestones_.clear();
+
+    std::nth_element(players.begin(), players.end() - topCount, players.end());
+
+    // Copy-assign over the retained elements so their name buffers are reused
+    top_.resize(topCount);
+    std::copy(players.end() - topCount, players.end(), top_.begin());
+    std::sort(top_.begin(), top_.end());
 
     auto end = std::chrono::high_resolution_clock::now();
-    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+    elapsed_ = std::chrono::duration<double, std::milli>(end - start).count();
+    return view();
+}
 
-    return RankingResult(topPlayers, cutoffs, elapsed);
-}
\ No newline at end of file
+/**
+ * @brief Exhausts <stream>, as Online::rankIncoming(), into the Ranker's storage.
+ */
+RankingView Ranker::rank(PlayerStream& stream, const size_t& reporting_interval) {
+    top_.clear();
+    milestones_.clear();
+
+    NullInstrumentation none;
+    MilestoneRecorder recorder { milestones_ };
+    elapsed_ = Online::detail::ingestTop([&stream]() { return stream.nextPlayer(); },
+        stream.remaining(), reporting_interval, none, top_, recorder);
+    return view();
+}
+
+/**
+ * @brief Moves the most recent result out of the Ranker.
+ */
+RankingResult Ranker::take() {
+    std::unordered_map<size_t, size_t> cutoffs;
+    cutoffs.reserve(milestones_.size());
+    for (const Milestone& milestone : milestones_) {
+        cutoffs[milestone.count_] = milestone.level_;
+    }
+    RankingResult result(std::move(top_), std::move(cutoffs), elapsed_);
+
+    top_ = std::vector<Player>();
+    milestones_ = std::vector<Milestone>();
+    return result;
+}
@@ -1,12 +1,25 @@
 #pragma once
 
+#include "Instrumentation.hpp"
+#include "PerfCounters.hpp"
 #include "Player.hpp"
 #include "PlayerStream.hpp"
+#include "SmallTopK.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
 #include <iterator>
+#include <memory_resource>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+class CsvRoster;
+class LevelIndex;
+class PlayerFile;
+
 struct RankingResult {
     /**
      * @brief The collection of top-ranked players.
@@ -41,6 +54,22 @@ struct RankingResult {
      */
     double elapsed_;
 
+    /**
+     * @brief Work counters for the ranking operation.
+     *
+     * Only populated by the engine overloads taking a CountingInstrumentation;
+     * all zero otherwise.
+     */
+    RankingStats stats_;
+
+    /**
+     * @brief Hardware event counts for the ranking operation.
+     *
+     * Only populated when the call is wrapped in withCounters(); see
+     * HardwareCounters::available_ for which counts are meaningful.
+     */
+    HardwareCounters counters_;
+
     /**
      * @brief Constructor for RankingResult with top players, cutoffs, and elapsed time.
      *
@@ -52,6 +81,120 @@ struct RankingResult {
      * @param elapsed Time taken to calculate the ranking, in ms.
      */
     RankingResult(const std::vector<Player>& top = {}, const std::unordered_map<size_t, size_t>& cutoffs = {}, double elapsed = 0);
+
+    /**
+     * @brief Constructor for RankingResult taking ownership of the top players
+     * & cutoffs, which are moved rather than copied. Every engine builds its
+     * result this way, so no ranking copies its own output.
+     *
+     * @param top Vector of top-ranked Player objects, in sorted order.
+     * @param cutoffs Map of player count thresholds to minimum level cutoffs.
+     * @param elapsed Time taken to calculate the ranking, in ms.
+     */
+    RankingResult(std::vector<Player>&& top, std::unordered_map<size_t, size_t>&& cutoffs, double elapsed);
+
+    /**
+     * @brief Combines partial rankings, eg. one per server stream, into the
+     *        top <k> of their union with a k-way loser tree merge, in
+     *        O(m + k log m) for m parts.
+     *
+     * The result is the exact global top <k> whenever each part holds the top
+     * <k> of its own Players (or all of them). Each part's top_ must be sorted
+     * in ascending order, as every engine returns it.
+     *
+     * Milestones recorded at the same count in different streams do not line
+     * up in any global order, so only the final milestone is combined: if
+     * every part has cutoffs_, the result maps the sum of their final counts
+     * to the lowest level of the merged board.
+     *
+     * @param parts The partial rankings to combine
+     * @param k The size of the combined board
+     * @return A Ranking Result object whose
+     * - top_ vector -> Contains the top min(<k>, total) Players of <parts> in sorted order (ascending)
+     * - cutoffs_    -> Contains the combined final milestone, or is empty
+     * - elapsed_    -> Contains the duration (ms) of the merge
+     */
+    static RankingResult merge(const std::vector<RankingResult>& parts, size_t k);
+};
+
+/**
+ * @brief Runs a ranking call with <collector>'s hardware counters enabled &
+ * records them in the returned RankingResult's counters_.
+ *
+ * If the host does not permit perf events the call still runs normally &
+ * counters_ is left empty.
+ *
+ * @param call Any callable returning a RankingResult, eg. a lambda invoking an engine
+ */
+template <typename Call>
+RankingResult withCounters(PerfCollector& collector, Call&& call) {
+    collector.start();
+    RankingResult result = std::forward<Call>(call)();
+    result.counters_ = collector.stop();
+    return result;
+}
+
+/**
+ * @brief A RankingResult whose containers allocate from a caller-supplied
+ * std::pmr::memory_resource, eg. a RankingArena, rather than the global heap.
+ *
+ * Returned by the engine overloads taking a memory resource. Its members
+ * have the same meaning as RankingResult's.
+ *
+ * @note The Players themselves are copied as usual, so names longer than the
+ *       small-string buffer still allocate from the global heap.
+ */
+struct PmrRankingResult {
+    std::pmr::vector<Player> top_;
+    std::pmr::unordered_map<size_t, size_t> cutoffs_;
+    double elapsed_;
+
+    /**
+     * @brief Constructs an empty result allocating from <resource>.
+     */
+    explicit PmrRankingResult(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+};
+
+/**
+ * @brief A cutoff recorded after <count_> Players, as in RankingResult::cutoffs_.
+ */
+struct Milestone {
+    size_t count_;
+    size_t level_;
+};
+
+/**
+ * @brief A read-only, non-owning ranking result.
+ *
+ * Returned where copying the winners out would be wasted work for callers
+ * that read the ranking immediately:
+ * - Ranker::rank() -> points into the Ranker's storage, & is invalidated by
+ *   the next rank() or take() on the same Ranker
+ * - Offline::quickSelectRankInPlace() & heapRankInPlace() -> points into the
+ *   tail of the caller's vector, & is invalidated by any change to it
+ */
+struct RankingView {
+    /**
+     * @brief The top Players, sorted in ascending order by level.
+     */
+    const Player* top_;
+    size_t size_;
+
+    /**
+     * @brief The cutoffs, in ascending order of count_. Empty for offline rankings.
+     */
+    const Milestone* cutoffs_;
+    size_t cutoffCount_;
+
+    /**
+     * @brief The duration (ms) of the selection/sorting operation.
+     */
+    double elapsed_;
+
+    const Player* begin() const { return top_; }
+    const Player* end() const { return top_ + size_; }
+    size_t size() const { return size_; }
+    const Player& operator[](size_t i) const { return top_[i]; }
 };
 
 namespace Offline {
@@ -84,6 +227,129 @@ RankingResult quickSelectRank(std::vector<Player>& players);
  * @post The order of the parameter vector is modified.
  */
 RankingResult heapRank(std::vector<Player>& players);
+
+/**
+ * @brief Instrumented versions of quickSelectRank() & heapRank().
+ *
+ * Every hook of <instrumentation> is invoked as the engine works, & the
+ * returned RankingResult's stats_ holds instrumentation.stats(). Defined for
+ * NullInstrumentation (identical code to the plain overloads) &
+ * CountingInstrumentation.
+ */
+template <typename Instrumentation>
+RankingResult quickSelectRank(std::vector<Player>& players, Instrumentation& instrumentation);
+
+template <typename Instrumentation>
+RankingResult heapRank(std::vector<Player>& players, Instrumentation& instrumentation);
+
+/**
+ * @brief Versions of quickSelectRank() & heapRank() whose result, & any
+ * working buffer, is allocated from <resource>.
+ *
+ * @param resource The memory resource to allocate from, eg. a RankingArena.
+ *      It must outlive the returned result.
+ */
+PmrRankingResult quickSelectRank(std::vector<Player>& players, std::pmr::memory_resource* resource);
+PmrRankingResult heapRank(std::vector<Player>& players, std::pmr::memory_resource* resource);
+
+/**
+ * @brief Versions of quickSelectRank() & heapRank() that rank the top 10% of
+ * <players> in place rather than copying it out.
+ *
+ * @return A RankingView over the tail of <players>, which holds the top 10%
+ *      sorted in ascending order. cutoffs_ is empty.
+ *
+ * @post The order of the parameter vector is modified, & the returned view
+ *      is only valid until <players> is next modified or destroyed.
+ */
+RankingView quickSelectRankInPlace(std::vector<Player>& players);
+RankingView heapRankInPlace(std::vector<Player>& players);
+
+/**
+ * @brief A quickSelectRank() whose selection & sort use the branchless block
+ * partitioning of BlockSort.hpp instead of std::nth_element() & std::sort().
+ *
+ * @param players A reference to the vector of Player objects to be ranked
+ * @return A Ranking Result object whose
+ * - top_ vector -> Contains the top 10% of players from the input in sorted order (ascending)
+ * - cutoffs_    -> Is empty
+ * - elapsed_    -> Contains the duration (ms) of the selection/sorting operation
+ *
+ * @post The order of the parameter vector is modified.
+ */
+RankingResult blockQuickSelectRank(std::vector<Player>& players);
+
+/**
+ * @brief Selects & sorts the top 10% of players by estimating the cutoff
+ *        from a random sample, without modifying the input.
+ *
+ * 1) A few thousand levels are sampled & sorted to find a lower bracket that
+ *    is below the true cutoff with overwhelming probability.
+ * 2) A single read-only pass (split across <threads>) collects the indices of
+ *    every Player at or above the bracket into small candidate buffers.
+ * 3) An exact select & sort over the candidates yields the result.
+ *
+ * If the bracket misses (fewer than ceil(N / 10) candidates), or the input
+ * is too small to be worth sampling, it falls back to an exact
+ * quickSelectRank() over a copy of the input. Either way the result is exact.
+ *
+ * @param players The Players to be ranked
+ * @param threads The number of threads for the filtering pass, or 0 for
+ *      one per hardware thread
+ * @return A Ranking Result object whose
+ * - top_ vector -> Contains the top 10% of players from the input in sorted order (ascending)
+ * - cutoffs_    -> Is empty
+ * - elapsed_    -> Contains the duration (ms) of the selection/sorting operation
+ */
+RankingResult sampleSelectRank(const std::vector<Player>& players, size_t threads = 1);
+
+/**
+ * @brief A quickSelectRank() over a memory-mapped roster file.
+ *
+ * Selection runs over a copy of the mapped level column only; Players are
+ * materialized solely for the top 10%, so the file is never parsed in full.
+ *
+ * @param roster A mapped roster file (left unmodified)
+ * @return A Ranking Result identical in levels to quickSelectRank() over the
+ *         file's Players, with each Player's id_ populated.
+ */
+RankingResult quickSelectRank(const PlayerFile& roster);
+
+/**
+ * @brief A heapRank() over a memory-mapped roster file.
+ *
+ * Scans the mapped level column in place, keeping a min-heap of the
+ * (level, row) pairs of the top 10%, so no copy of the column is made.
+ *
+ * @param roster A mapped roster file (left unmodified)
+ * @return A Ranking Result identical in levels to heapRank() over the
+ *         file's Players, with each Player's id_ populated.
+ */
+RankingResult heapRank(const PlayerFile& roster);
+
+/**
+ * @brief A quickSelectRank() over a roster loaded by loadCsvRoster().
+ *
+ * Selection runs over a copy of the per-chunk level columns only;
+ * Players are materialized solely for the top 10%.
+ *
+ * @param roster A parsed roster (left unmodified)
+ * @return A Ranking Result identical in levels to quickSelectRank() over the
+ *         roster's Players, with each Player's id_ populated.
+ */
+RankingResult quickSelectRank(const CsvRoster& roster);
+
+/**
+ * @brief A heapRank() over a roster loaded by loadCsvRoster().
+ *
+ * Scans the per-chunk level columns in place, keeping a min-heap of the
+ * (level, row) pairs of the top 10%.
+ *
+ * @param roster A parsed roster (left unmodified)
+ * @return A Ranking Result identical in levels to heapRank() over the
+ *         roster's Players, with each Player's id_ populated.
+ */
+RankingResult heapRank(const CsvRoster& roster);
 };
 
 namespace Online {
@@ -116,6 +382,16 @@ using PlayerIt = std::vector<Player>::iterator;
  */
 void replaceMin(PlayerIt first, PlayerIt last, Player& target);
 
+using PmrPlayerIt = std::pmr::vector<Player>::iterator;
+
+/**
+ * @brief An instrumented replaceMin(), reporting its comparisons, swaps &
+ * sift depth to <instrumentation>. Defined for PlayerIt & PmrPlayerIt, with
+ * NullInstrumentation & CountingInstrumentation.
+ */
+template <typename Iterator, typename Instrumentation>
+void replaceMin(Iterator first, Iterator last, Player& target, Instrumentation& instrumentation);
+
 /**
  * @brief Exhausts a stream of Players (ie. until there are none left) such that we:
  * 1) Maintain a running collection of the <reporting_interval> highest leveled players
@@ -148,4 +424,467 @@ void replaceMin(PlayerIt first, PlayerIt last, Player& target);
  * elapsed_ = 0.003 (Your runtime will vary based on hardware)
  */
 RankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interval);
-};
\ No newline at end of file
+
+/**
+ * @brief An instrumented rankIncoming(); the returned RankingResult's stats_
+ * holds instrumentation.stats().
+ */
+template <typename Instrumentation>
+RankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interval, Instrumentation& instrumentation);
+
+/**
+ * @brief A rankIncoming() whose heap, & so its result, is allocated from
+ * <resource>, which must outlive the returned result.
+ */
+PmrRankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interval, std::pmr::memory_resource* resource);
+
+/**
+ * @brief A rankIncoming() that also adds every Player's level to <index> as
+ * it is ingested, so global ranks can be queried alongside the top slice.
+ *
+ * @throws std::out_of_range if a level exceeds index.maxLevel(). The stream
+ *      cannot be checked ahead of time, so the Players ingested before the
+ *      offending one stay in <index> (& out of the stream); size the index
+ *      for the highest level the stream can hold, or rebuild it on failure.
+ */
+RankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interval, LevelIndex& index);
+
+/**
+ * @brief Detects types usable as a Player stream without going through the
+ * PlayerStream interface, ie. any type providing `nextPlayer()` yielding a
+ * Player & `remaining()` yielding a count.
+ */
+template <typename Stream, typename = void>
+struct is_player_stream : std::false_type { };
+
+template <typename Stream>
+struct is_player_stream<Stream,
+    std::void_t<decltype(Player(std::declval<Stream&>().nextPlayer())),
+        decltype(static_cast<size_t>(std::declval<const Stream&>().remaining()))>>
+    : std::true_type { };
+
+/**
+ * @brief Detects streams that can lend their next Player by reference
+ * through `nextPlayerRef()`, such as PlayerSpanStream.
+ */
+template <typename Stream, typename = void>
+struct has_player_ref : std::false_type { };
+
+template <typename Stream>
+struct has_player_ref<Stream, std::void_t<decltype(std::declval<Stream&>().nextPlayerRef())>>
+    : std::true_type { };
+
+namespace detail {
+/**
+ * @brief The milestone loop shared by every online engine: feeds <total>
+ * fetched Players to <board>, records board.milestone() after every
+ * <reporting_interval> Players & after the last one, then calls
+ * board.finish().
+ *
+ * A board ranks the Players it is pushed into the top-player vector it was
+ * constructed over:
+ * - push(next)  -> takes the next Player, by value or by reference
+ * - milestone() -> returns the current cutoff level
+ * - finish()    -> leaves the top-player vector sorted in ascending order
+ *
+ * @param fetch A callable returning the next Player, either by value or by
+ *      reference.
+ * @param total The number of Players fetch() will yield.
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @param board The board ranking the Players
+ * @param cutoffs An empty map receiving the cutoff at each milestone
+ * @return The elapsed time, in ms
+ */
+template <typename Fetch, typename Board, typename Cutoffs>
+double ingestBoard(Fetch&& fetch, size_t total, size_t reporting_interval, Board& board, Cutoffs& cutoffs) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    cutoffs.reserve(total / std::max<size_t>(reporting_interval, 1) + 1);
+
+    for (size_t playerCount = 1; playerCount <= total; ++playerCount) {
+        board.push(fetch());
+
+        // Record cutoff at each reporting interval
+        if (playerCount % reporting_interval == 0) {
+            cutoffs[playerCount] = board.milestone();
+        }
+    }
+
+    // Record final cutoff if not already recorded
+    if (total % reporting_interval != 0) {
+        cutoffs[total] = board.milestone();
+    }
+
+    board.finish();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/**
+ * @brief The board of rankIncoming(): a min-heap of the <capacity> highest
+ * leveled Players, filled unconditionally & then updated through replaceMin().
+ */
+template <typename Heap, typename Instrumentation>
+class HeapBoard {
+private:
+    Heap& heap_;
+    size_t capacity_;
+    size_t vacant_; // Slots left before the heap is full
+    Instrumentation& instrumentation_;
+
+public:
+    HeapBoard(Heap& heap, size_t capacity, Instrumentation& instrumentation)
+        : heap_ { heap }
+        , capacity_ { capacity }
+        , vacant_ { capacity }
+        , instrumentation_ { instrumentation }
+    {
+    }
+
+    template <typename Next>
+    void push(Next&& next) {
+        // Initialize the min-heap with the first <capacity> Players
+        if (vacant_ > 0) {
+            heap_.push_back(std::forward<Next>(next));
+            instrumentation_.move();
+            if (--vacant_ == 0) {
+                std::make_heap(heap_.begin(), heap_.end(), instrument(std::greater<Player>(), instrumentation_));
+            }
+            return;
+        }
+
+        // If the new player has a higher level than the minimum in the heap
+        instrumentation_.compare();
+        if (next.level_ > heap_.front().level_) {
+            Player incoming(std::forward<Next>(next));
+            instrumentation_.move();
+            Online::replaceMin(heap_.begin(), heap_.end(), incoming, instrumentation_);
+        }
+    }
+
+    size_t milestone() {
+        // A stream shorter than the capacity only reaches its final milestone
+        if (vacant_ > 0) {
+            std::make_heap(heap_.begin(), heap_.end(), instrument(std::greater<Player>(), instrumentation_));
+        }
+        return heap_.front().level_;
+    }
+
+    void finish() {
+        std::sort(heap_.begin(), heap_.end(), instrument(std::less<Player>(), instrumentation_));
+    }
+};
+
+/**
+ * @brief The board of rankIncoming() for at most SmallTopK::MAX_K Players:
+ * levels are ranked by a SmallTopK while <players> holds the Players in the
+ * slots it hands out.
+ */
+template <typename Heap>
+class SmallBoard {
+private:
+    SmallTopK ranks_;
+    Heap& players_;
+
+public:
+    SmallBoard(Heap& players, size_t capacity)
+        : ranks_ { capacity }
+        , players_ { players }
+    {
+    }
+
+    template <typename Next>
+    void push(Next&& next) {
+        size_t slot = ranks_.push(next.level_);
+        if (slot == players_.size()) {
+            players_.push_back(std::forward<Next>(next));
+        } else if (slot != SmallTopK::REJECTED) {
+            players_[slot] = std::forward<Next>(next);
+        }
+    }
+
+    size_t milestone() {
+        return ranks_.cutoff();
+    }
+
+    void finish() {
+        std::sort(players_.begin(), players_.end());
+    }
+};
+
+/**
+ * @brief The ingest loop shared by every rankIncoming() overload.
+ *
+ * @param fetch A callable returning the next Player, either by value or by
+ *      reference. Players fetched by reference are only copied if they
+ *      enter the heap.
+ * @param total The number of Players fetch() will yield.
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @param instrumentation The policy receiving the loop's work counters
+ * @param topPlayers An empty vector receiving the top Players, in ascending order
+ * @param cutoffs An empty map receiving the cutoff at each milestone
+ * @return The elapsed time, in ms
+ */
+template <typename Fetch, typename Instrumentation, typename Heap, typename Cutoffs>
+double ingestTop(Fetch&& fetch, size_t total, const size_t& reporting_interval, Instrumentation& instrumentation,
+    Heap& topPlayers, Cutoffs& cutoffs) {
+    // Size the heap up front: one allocation, & none on the hot path
+    topPlayers.reserve(std::min(reporting_interval, total));
+    instrumentation.allocate();
+
+    // Small boards are ranked by SmallTopK's vector compares rather than a heap
+    if constexpr (!Instrumentation::enabled) {
+        if (reporting_interval > 0 && reporting_interval <= SmallTopK::MAX_K) {
+            SmallBoard<Heap> board(topPlayers, reporting_interval);
+            return ingestBoard(std::forward<Fetch>(fetch), total, reporting_interval, board, cutoffs);
+        }
+    }
+
+    HeapBoard<Heap, Instrumentation> board(topPlayers, reporting_interval, instrumentation);
+    return ingestBoard(std::forward<Fetch>(fetch), total, reporting_interval, board, cutoffs);
+}
+
+/**
+ * @brief Runs ingestTop() into a RankingResult.
+ */
+template <typename Fetch, typename Instrumentation>
+RankingResult rankIncomingCore(Fetch&& fetch, size_t total, const size_t& reporting_interval, Instrumentation& instrumentation) {
+    std::vector<Player> topPlayers;
+    std::unordered_map<size_t, size_t> cutoffs;
+
+    double elapsed = ingestTop(std::forward<Fetch>(fetch), total, reporting_interval, instrumentation, topPlayers, cutoffs);
+
+    RankingResult result(std::move(topPlayers), std::move(cutoffs), elapsed);
+    result.stats_ = instrumentation.stats();
+    return result;
+}
+
+/**
+ * @brief rankIncomingCore() without instrumentation.
+ */
+template <typename Fetch>
+RankingResult rankIncomingCore(Fetch&& fetch, size_t total, const size_t& reporting_interval) {
+    NullInstrumentation none;
+    return rankIncomingCore(std::forward<Fetch>(fetch), total, reporting_interval, none);
+}
+
+/**
+ * @brief Runs ingestBoard() into a RankingResult, ranking with a <Board>
+ * constructed over the result's top-player vector & <args>.
+ *
+ * @example detail::rankIncomingCore<MyBoard>(fetch, total, 100, threshold)
+ */
+template <typename Board, typename Fetch, typename... Args>
+RankingResult rankIncomingCore(Fetch&& fetch, size_t total, const size_t& reporting_interval, Args&&... args) {
+    std::vector<Player> topPlayers;
+    std::unordered_map<size_t, size_t> cutoffs;
+
+    Board board(topPlayers, std::forward<Args>(args)...);
+    double elapsed = ingestBoard(std::forward<Fetch>(fetch), total, reporting_interval, board, cutoffs);
+
+    return RankingResult(std::move(topPlayers), std::move(cutoffs), elapsed);
+}
+}
+
+/**
+ * @brief A statically dispatched rankIncoming() for concrete stream types.
+ *
+ * Behaves exactly like rankIncoming(PlayerStream&, ...), but calls
+ * `nextPlayer()` on the concrete type so it can be inlined, & reads
+ * `remaining()` once up front rather than on every iteration. Streams
+ * providing `nextPlayerRef()` are read by reference instead.
+ *
+ * @pre No other consumer reads from the stream during the call.
+ */
+template <typename Stream, typename = std::enable_if_t<is_player_stream<Stream>::value>>
+RankingResult rankIncoming(Stream& stream, const size_t& reporting_interval) {
+    if constexpr (has_player_ref<Stream>::value) {
+        // Borrow each Player & only copy the ones entering the heap
+        return detail::rankIncomingCore([&stream]() -> decltype(auto) { return stream.nextPlayerRef(); },
+            stream.remaining(), reporting_interval);
+    } else {
+        return detail::rankIncomingCore([&stream]() { return stream.nextPlayer(); },
+            stream.remaining(), reporting_interval);
+    }
+}
+
+/**
+ * @brief A rankIncoming() over a range of Players, [first, last).
+ *
+ * Players are read by reference & only copied if they enter the heap,
+ * so ranking an in-memory vector never copies rejected Players.
+ *
+ * @param first A forward iterator to the first Player of the range
+ * @param last A forward iterator one past the last Player of the range
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @return The same RankingResult as rankIncoming() over a stream of [first, last)
+ */
+template <typename ForwardIt>
+RankingResult rankIncoming(ForwardIt first, ForwardIt last, const size_t& reporting_interval) {
+    size_t total = static_cast<size_t>(std::distance(first, last));
+    return detail::rankIncomingCore([&first]() -> decltype(*first) { return *first++; },
+        total, reporting_interval);
+}
+
+/**
+ * @brief Maintains the top 10% of an unbounded stream of Players, where the
+ * leaderboard capacity grows to ceil(count / 10) as Players arrive.
+ *
+ * Players are split across two heaps:
+ * - winners_   -> a min-heap holding exactly ceil(count / 10) Players
+ * - reservoir_ -> a max-heap holding every other Player seen so far
+ *
+ * Every Player in the reservoir is no greater than every Player in winners_,
+ * so growing the capacity by one promotes the reservoir's root, and a new
+ * Player beating the current cutoff demotes winners_' root. Each push is
+ * therefore amortized O(log N).
+ *
+ * @note The reservoir cannot be bounded: on a descending stream every
+ *       promotion comes from the reservoir, so any Player seen so far may
+ *       eventually be needed.
+ *
+ * @example Pushing levels 5, 1, 9 then 3 (capacity 1 throughout):
+ * cutoff() -> 5, 5, 9, 9
+ * top()    -> { Player(.., 9) }
+ */
+class TopFractionRanker {
+private:
+    std::vector<Player> winners_;
+    std::vector<Player> reservoir_;
+    size_t count_;
+
+public:
+    /**
+     * @brief Constructs an empty ranker.
+     */
+    TopFractionRanker();
+
+    /**
+     * @brief Adds a Player to the ranker, growing the capacity when needed.
+     *
+     * @param player The Player to add. It is moved into the ranker.
+     * @post winners_ holds the ceil(count() / 10) highest leveled Players seen.
+     */
+    void push(Player player);
+
+    /**
+     * @brief Returns the number of Players pushed so far.
+     */
+    size_t count() const;
+
+    /**
+     * @brief Returns the current leaderboard capacity, ceil(count() / 10).
+     */
+    size_t capacity() const;
+
+    /**
+     * @brief Returns the minimum level required to be on the leaderboard.
+     *
+     * @throws std::runtime_error if no Players have been pushed.
+     */
+    size_t cutoff() const;
+
+    /**
+     * @brief Returns the current leaderboard, sorted in ascending order by level.
+     *
+     * Matches the top_ of Offline::quickSelectRank() over every Player pushed so far.
+     */
+    std::vector<Player> top() const;
+};
+
+/**
+ * @brief Exhausts a stream of Players (ie. until there are none left) such that we:
+ * 1) Maintain a running collection of the top 10% of players read so far
+ * 2) Record the Player level after reading every <reporting_interval> players
+ *    representing the minimum level required to be in the leaderboard at that point.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @return A RankingResult in which:
+ * - top_       -> Contains the top ceil(N / 10) Players read in the stream in
+ *                 sorted (least to greatest) order
+ * - cutoffs_   -> Maps player count milestones to minimum level required at that point
+ *                 including the minimum level after ALL players have been read
+ * - elapsed_   -> Contains the duration (ms) of the selection/sorting operation
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankTopFraction(PlayerStream& stream, const size_t& reporting_interval);
+
+/**
+ * @brief An adaptive version of rankIncoming() for streams trending upwards.
+ *
+ * On ascending streams almost every Player beats the heap's minimum and pays
+ * a full replaceMin() percolation. This engine tracks the acceptance rate over
+ * each reporting interval and, once it exceeds <acceptance_threshold>, switches
+ * to a buffered mode: Players beating the (stale) cutoff are appended to a
+ * buffer, which is folded into the heap at every milestone with a single
+ * selection over heap + buffer. Since the buffer never holds more than
+ * <reporting_interval> Players, each fold costs O(reporting_interval), i.e.
+ * amortized O(1) per Player. It returns to heap mode once the acceptance
+ * rate falls below half the threshold.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @param acceptance_threshold The fraction of accepted Players in an interval
+ *        above which buffered mode is used
+ * @return A RankingResult identical in top_ levels & cutoffs_ to rankIncoming()
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankIncomingAdaptive(PlayerStream& stream, const size_t& reporting_interval, double acceptance_threshold = 0.5);
+};
+
+/**
+ * @brief A reusable ranking engine that keeps its working storage between calls.
+ *
+ * Each free function in Offline & Online allocates a fresh top-player vector
+ * & cutoff map for every call. A Ranker instead owns that storage & only
+ * clears it between calls, so once it has grown to the largest ranking seen,
+ * repeated rank() calls do not allocate (beyond Player names too long for
+ * the small-string buffer).
+ *
+ * @example
+ *   Ranker ranker;
+ *   for (auto& request : requests) {
+ *       RankingView view = ranker.rank(request.stream_, 100);
+ *       respond(view);            // Read the view before the next rank()
+ *   }
+ *   RankingResult kept = ranker.take(); // Or move the last result out
+ */
+class Ranker {
+private:
+    std::vector<Player> top_;
+    std::vector<Milestone> milestones_;
+    double elapsed_;
+
+    RankingView view() const;
+
+public:
+    /**
+     * @brief Constructs a Ranker with no storage.
+     */
+    Ranker();
+
+    /**
+     * @brief Selects & sorts the top 10% of <players>, as Offline::quickSelectRank().
+     *
+     * @post The order of the parameter vector is modified.
+     */
+    RankingView rank(std::vector<Player>& players);
+
+    /**
+     * @brief Exhausts <stream>, as Online::rankIncoming().
+     *
+     * @post All elements of the stream are read until there are none remaining.
+     */
+    RankingView rank(PlayerStream& stream, const size_t& reporting_interval);
+
+    /**
+     * @brief Moves the most recent result out of the Ranker.
+     *
+     * The Ranker gives up its storage, so the next rank() allocates afresh.
+     */
+    RankingResult take();
+};
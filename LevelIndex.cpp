@@ -0,0 +1,99 @@
+#include "LevelIndex.hpp"
+
+#include <algorithm>
+
+namespace {
+/**
+ * @brief Returns <maxLevel> if an index over [0, <maxLevel>] may be built.
+ *
+ * Checked before sizing the tree, where maxLevel + 2 would otherwise wrap
+ * for levels near SIZE_MAX or ask for terabytes for levels like 1e12.
+ */
+size_t checkedMaxLevel(size_t maxLevel) {
+    if (maxLevel > LevelIndex::MAX_LEVEL) {
+        throw std::out_of_range("Level " + std::to_string(maxLevel) + " exceeds the largest indexable level, "
+            + std::to_string(LevelIndex::MAX_LEVEL) + ".");
+    }
+    return maxLevel;
+}
+}
+
+/**
+ * @brief Constructs an empty index over the levels [0, <maxLevel>].
+ * @throws std::out_of_range if <maxLevel> exceeds MAX_LEVEL.
+ */
+LevelIndex::LevelIndex(size_t maxLevel)
+    : tree_(checkedMaxLevel(maxLevel) + 2, 0)
+    , maxLevel_ { maxLevel }
+    , size_ { 0 }
+{
+}
+
+/**
+ * @brief Constructs an index of every Player in <players>, over the levels
+ *        [0, highest level present], in O(N + L).
+ * @throws std::out_of_range if the highest level exceeds MAX_LEVEL.
+ */
+LevelIndex::LevelIndex(const std::vector<Player>& players)
+    : LevelIndex(players.empty() ? 0 : std::max_element(players.begin(), players.end())->level_)
+{
+    for (const Player& player : players) {
+        tree_[player.level_ + 1]++;
+    }
+    // Fold each counter into its parent once, rather than O(log L) updates per Player
+    for (size_t i = 1; i < tree_.size(); ++i) {
+        size_t parent = i + (i & (~i + 1));
+        if (parent < tree_.size()) {
+            tree_[parent] += tree_[i];
+        }
+    }
+    size_ = players.size();
+}
+
+/**
+ * @brief Returns the number of Players at or below <level>.
+ */
+size_t LevelIndex::countAtOrBelow(size_t level) const {
+    size_t count = 0;
+    for (size_t i = std::min(level, maxLevel_) + 1; i > 0; i &= i - 1) {
+        count += tree_[i];
+    }
+    return count;
+}
+
+/**
+ * @brief Returns the number of Players strictly above <level>.
+ */
+size_t LevelIndex::countAbove(size_t level) const {
+    return level >= maxLevel_ ? 0 : size_ - countAtOrBelow(level);
+}
+
+/**
+ * @brief Returns the level of the Player at <rank>, counting 1 as the highest.
+ *
+ * Descends the tree for the (size() - rank + 1)-th lowest level, halving the
+ * step each time, so it costs one pass of O(log L) rather than a binary
+ * search over countAbove().
+ *
+ * @throws std::out_of_range if <rank> is 0 or exceeds size().
+ */
+size_t LevelIndex::levelAtRank(size_t rank) const {
+    if (rank == 0 || rank > size_) {
+        throw std::out_of_range("Rank " + std::to_string(rank) + " is outside the index.");
+    }
+    uint64_t target = size_ - rank + 1;
+
+    size_t step = 1;
+    while (2 * step < tree_.size()) {
+        step *= 2;
+    }
+    // The largest position whose prefix holds fewer than target Players
+    size_t position = 0;
+    for (; step > 0; step /= 2) {
+        if (position + step < tree_.size() && tree_[position + step] < target) {
+            position += step;
+            target -= tree_[position];
+        }
+    }
+    return position; // Tree position position + 1 holds level position
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include "Player.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @brief An order-statistic index over Player levels: a Fenwick (binary
+ * indexed) tree with one counter per level in [0, maxLevel].
+ *
+ * Answers "what rank is a Player at this level" & "what level holds this
+ * rank" over every Player indexed, not just the top slice, in O(log L) for
+ * L = maxLevel + 1 levels. Adding, removing or moving a Player is also
+ * O(log L) & touches only a handful of counters, so the index keeps up with
+ * a live stream of level changes.
+ *
+ * Ranks are 1-based from the top, & Players sharing a level share the best
+ * rank among them ("competition" ranking): with levels { 9, 7, 7, 3 } the
+ * Players at 7 are both #2 & the Player at 3 is #4.
+ *
+ * @note Memory is 8 bytes per level of the domain, not per Player, so the
+ *       index suits bounded level ranges (eg. 0 to 10 million -> 80 MB), &
+ *       refuses any above MAX_LEVEL (2 GB of counters).
+ *
+ * @example
+ *   LevelIndex index(players);
+ *   index.rankOf(player.level_)  -> "you are #183,422"
+ *   index.levelAtRank(1000)      -> the level needed to reach the top 1000
+ *   index.move(oldLevel, newLevel);
+ */
+class LevelIndex {
+public:
+    // The highest maxLevel() an index may be built over
+    static constexpr size_t MAX_LEVEL = (size_t(1) << 28) - 1;
+
+private:
+    std::vector<uint64_t> tree_; // 1-based; tree_[i] sums levels (i - lowbit(i), i]
+    size_t maxLevel_;
+    size_t size_;
+
+    void update(size_t level, uint64_t delta) {
+        if (level > maxLevel_) {
+            throw std::out_of_range("Level " + std::to_string(level) + " is outside the index.");
+        }
+        for (size_t i = level + 1; i < tree_.size(); i += i & (~i + 1)) {
+            tree_[i] += delta;
+        }
+    }
+
+    /**
+     * @brief Returns the number of Players at or below <level>.
+     */
+    size_t countAtOrBelow(size_t level) const;
+
+public:
+    /**
+     * @brief Constructs an empty index over the levels [0, <maxLevel>].
+     * @throws std::out_of_range if <maxLevel> exceeds MAX_LEVEL.
+     */
+    explicit LevelIndex(size_t maxLevel);
+
+    /**
+     * @brief Constructs an index of every Player in <players>, over the levels
+     *        [0, highest level present], in O(N + L).
+     * @throws std::out_of_range if the highest level exceeds MAX_LEVEL.
+     */
+    explicit LevelIndex(const std::vector<Player>& players);
+
+    /**
+     * @brief Indexes a Player at <level>.
+     * @throws std::out_of_range if <level> exceeds maxLevel().
+     */
+    void add(size_t level) {
+        update(level, 1);
+        size_++;
+    }
+
+    /**
+     * @brief Removes a Player at <level> from the index.
+     * @pre A Player at <level> is indexed.
+     * @throws std::out_of_range if <level> exceeds maxLevel().
+     */
+    void remove(size_t level) {
+        update(level, ~uint64_t(0));
+        size_--;
+    }
+
+    /**
+     * @brief Moves an indexed Player from <oldLevel> to <newLevel>, eg. on a level up.
+     * @pre A Player at <oldLevel> is indexed.
+     * @throws std::out_of_range if either level exceeds maxLevel(), leaving
+     *      the index unchanged.
+     */
+    void move(size_t oldLevel, size_t newLevel) {
+        if (newLevel > maxLevel_) {
+            update(newLevel, 1); // Throws before remove() can change anything
+        }
+        remove(oldLevel);
+        add(newLevel);
+    }
+
+    /**
+     * @brief Returns the number of Players strictly above <level>.
+     */
+    size_t countAbove(size_t level) const;
+
+    /**
+     * @brief Returns the rank of a Player at <level>: 1 + the number of Players above it.
+     */
+    size_t rankOf(size_t level) const { return countAbove(level) + 1; }
+
+    /**
+     * @brief Returns the level of the Player at <rank>, counting 1 as the highest.
+     * @throws std::out_of_range if <rank> is 0 or exceeds size().
+     */
+    size_t levelAtRank(size_t rank) const;
+
+    /**
+     * @brief Returns the number of Players indexed.
+     */
+    size_t size() const { return size_; }
+
+    /**
+     * @brief Returns the highest level the index can hold.
+     */
+    size_t maxLevel() const { return maxLevel_; }
+};
@@ -0,0 +1,310 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A tournament ("loser") tree over m sources, each exposing one key.
+ *
+ * The m sources are the leaves of a complete binary tree; each internal node
+ * stores the loser of the match played there & node 0 stores the overall
+ * winner. After the winner's source is advanced, replay() only re-plays the
+ * matches on its path to the root: floor(log2 m) or ceil(log2 m) comparisons,
+ * against the 2 log2 m of a binary heap's sift-down.
+ *
+ * The winner is the live source whose key is "before" every other under
+ * <Before> (std::greater gives the highest key); ties go to the lower
+ * source index, so merges are deterministic. Exhausted sources lose to
+ * every live one.
+ *
+ * @example Merging sorted runs from the highest level down:
+ *   LoserTree<size_t> tree(runs.size());
+ *   for (size_t r = 0; r < runs.size(); ++r) tree.set(r, runs[r].back().level_);
+ *   tree.build();
+ *   while (!tree.empty()) {
+ *       size_t r = tree.winner();
+ *       ... take runs[r].back(), pop it, then tree.set(r, ...) or tree.exhaust(r) ...
+ *       tree.replay(r);
+ *   }
+ */
+template <typename Key, typename Before = std::greater<Key>>
+class LoserTree {
+    std::vector<size_t> nodes_; // [0] = winner, [1, m) = losers of internal matches
+    std::vector<Key> keys_;
+    std::vector<char> live_;
+    Before before_;
+
+    bool beats(size_t a, size_t b) const {
+        if (!live_[a]) {
+            return false;
+        }
+        if (!live_[b]) {
+            return true;
+        }
+        return before_(keys_[a], keys_[b]) || (!before_(keys_[b], keys_[a]) && a < b);
+    }
+
+    /**
+     * @brief Plays every match below <node> & returns the winner there.
+     */
+    size_t play(size_t node) {
+        size_t sources = keys_.size();
+        if (node >= sources) {
+            return node - sources;
+        }
+        size_t left = play(2 * node);
+        size_t right = play(2 * node + 1);
+        if (beats(left, right)) {
+            nodes_[node] = right;
+            return left;
+        }
+        nodes_[node] = left;
+        return right;
+    }
+
+public:
+    /**
+     * @brief Constructs a tree over <sources> sources, all initially exhausted.
+     */
+    explicit LoserTree(size_t sources, Before before = Before())
+        : nodes_(std::max<size_t>(sources, 1))
+        , keys_(sources)
+        , live_(sources, 0)
+        , before_ { before }
+    {}
+
+    /**
+     * @brief Sets the current key of <source> & marks it live.
+     * Takes effect at the next build() or replay(source).
+     */
+    void set(size_t source, const Key& key) {
+        keys_[source] = key;
+        live_[source] = 1;
+    }
+
+    /**
+     * @brief Marks <source> as having no more keys.
+     * Takes effect at the next build() or replay(source).
+     */
+    void exhaust(size_t source) {
+        live_[source] = 0;
+    }
+
+    /**
+     * @brief Plays every match from scratch, in O(m).
+     */
+    void build() {
+        if (!keys_.empty()) {
+            nodes_[0] = play(1);
+        }
+    }
+
+    /**
+     * @brief Re-plays the matches of <source> after its key changed, in O(log m).
+     * @pre <source> is the current winner
+     */
+    void replay(size_t source) {
+        size_t winner = source;
+        for (size_t node = (source + keys_.size()) / 2; node > 0; node /= 2) {
+            if (beats(nodes_[node], winner)) {
+                std::swap(nodes_[node], winner);
+            }
+        }
+        nodes_[0] = winner;
+    }
+
+    /**
+     * @brief Returns the source holding the winning key.
+     * @pre !empty()
+     */
+    size_t winner() const { return nodes_[0]; }
+
+    /**
+     * @brief Returns the winning key.
+     * @pre !empty()
+     */
+    const Key& top() const { return keys_[nodes_[0]]; }
+
+    /**
+     * @brief Returns whether every source is exhausted.
+     */
+    bool empty() const { return keys_.empty() || !live_[nodes_[0]]; }
+
+    /**
+     * @brief Returns the number of sources.
+     */
+    size_t size() const { return keys_.size(); }
+};
+
+/**
+ * @brief k-way merging of sorted runs, eg. the per-thread or per-shard
+ * rankings of a parallel engine.
+ *
+ * A run is a [first, last) pair of random access iterators sorted under
+ * <before> on the key a Key functor extracts (eg. a Player's level_), as in
+ * BlockSort. Equal keys are output in the order of the runs holding them,
+ * so every merge here is stable & the parallel merge matches the serial one.
+ */
+namespace Merge {
+// The fewest outputs worth handing to another thread
+constexpr size_t PARALLEL_MIN_OUTPUT = 1 << 14;
+
+template <typename RandomIt>
+using Run = std::pair<RandomIt, RandomIt>;
+
+/**
+ * @brief Merges <runs> into <out> with a LoserTree, stopping after <limit>
+ * outputs: about log2(m) comparisons per output for m runs.
+ *
+ * @return The end of the output
+ */
+template <typename RandomIt, typename OutputIt, typename Key, typename Before = std::less<>>
+OutputIt mergeRuns(const std::vector<Run<RandomIt>>& runs, OutputIt out, size_t limit, Key key, Before before = Before()) {
+    using KeyType = std::decay_t<decltype(key(*std::declval<RandomIt>()))>;
+
+    LoserTree<KeyType, Before> tree(runs.size(), before);
+    std::vector<RandomIt> next(runs.size());
+    for (size_t r = 0; r < runs.size(); ++r) {
+        next[r] = runs[r].first;
+        if (next[r] != runs[r].second) {
+            tree.set(r, key(*next[r]));
+        }
+    }
+    tree.build();
+
+    for (; limit > 0 && !tree.empty(); --limit) {
+        size_t r = tree.winner();
+        *out = *next[r];
+        ++out;
+        if (++next[r] != runs[r].second) {
+            tree.set(r, key(*next[r]));
+        } else {
+            tree.exhaust(r);
+        }
+        tree.replay(r);
+    }
+    return out;
+}
+
+/**
+ * @brief Finds where the first <rank> outputs of merging <runs> end in each
+ * run (a multisequence merge path), in O(m log^2 n) comparisons.
+ *
+ * Repeatedly takes the middle key of the widest remaining window as a pivot
+ * & counts the keys below & at it in every window, until the pivot is the
+ * key at <rank>; its ties are then handed out in run order.
+ *
+ * @return The offset into each run at which the first <rank> outputs end
+ * @pre rank <= the total length of <runs>
+ */
+template <typename RandomIt, typename Key, typename Before = std::less<>>
+std::vector<size_t> partitionRuns(const std::vector<Run<RandomIt>>& runs, size_t rank, Key key, Before before = Before()) {
+    size_t count = runs.size();
+    std::vector<size_t> low(count, 0);
+    std::vector<size_t> high(count);
+    for (size_t r = 0; r < count; ++r) {
+        high[r] = static_cast<size_t>(runs[r].second - runs[r].first);
+    }
+    std::vector<size_t> below(count);
+    std::vector<size_t> atOrBelow(count);
+
+    while (true) {
+        // [low, high) of every run holds the answer; <rank> counts from the lows
+        size_t widest = count;
+        for (size_t r = 0; r < count; ++r) {
+            if (high[r] > low[r] && (widest == count || high[r] - low[r] > high[widest] - low[widest])) {
+                widest = r;
+            }
+        }
+        if (widest == count) {
+            return low; // Every window is empty, so rank is 0
+        }
+
+        auto pivot = key(runs[widest].first[low[widest] + (high[widest] - low[widest]) / 2]);
+        size_t countBelow = 0;
+        size_t countAtOrBelow = 0;
+        for (size_t r = 0; r < count; ++r) {
+            RandomIt first = runs[r].first;
+            below[r] = static_cast<size_t>(std::partition_point(first + low[r], first + high[r], [&](const auto& x) {
+                return before(key(x), pivot);
+            }) - first);
+            atOrBelow[r] = static_cast<size_t>(std::partition_point(first + below[r], first + high[r], [&](const auto& x) {
+                return !before(pivot, key(x));
+            }) - first);
+            countBelow += below[r] - low[r];
+            countAtOrBelow += atOrBelow[r] - low[r];
+        }
+
+        if (rank < countBelow) {
+            high = below;
+        } else if (rank >= countAtOrBelow) {
+            rank -= countAtOrBelow;
+            low = atOrBelow;
+        } else {
+            // The pivot's ties straddle <rank>
+            rank -= countBelow;
+            for (size_t r = 0; r < count; ++r) {
+                size_t ties = std::min(rank, atOrBelow[r] - below[r]);
+                below[r] += ties;
+                rank -= ties;
+            }
+            return below;
+        }
+    }
+}
+
+/**
+ * @brief A mergeRuns() that splits the output between <threads> threads
+ * (0 for one per core) with partitionRuns(), each merging its own slice of
+ * every run straight into its own slice of the output.
+ *
+ * @return The end of the output
+ * @pre <out> is a random access iterator
+ */
+template <typename RandomIt, typename OutputIt, typename Key, typename Before = std::less<>>
+OutputIt parallelMergeRuns(const std::vector<Run<RandomIt>>& runs, OutputIt out, size_t limit, size_t threads, Key key, Before before = Before()) {
+    size_t total = 0;
+    for (const Run<RandomIt>& run : runs) {
+        total += static_cast<size_t>(run.second - run.first);
+    }
+    total = std::min(total, limit);
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::max<size_t>(1, std::min(threads, total / PARALLEL_MIN_OUTPUT));
+    if (threads == 1) {
+        return mergeRuns(runs, out, total, key, before);
+    }
+
+    std::vector<std::vector<size_t>> bounds(threads + 1);
+    bounds[0].assign(runs.size(), 0);
+    for (size_t t = 1; t <= threads; ++t) {
+        bounds[t] = partitionRuns(runs, total * t / threads, key, before);
+    }
+
+    auto merge = [&](size_t t) {
+        std::vector<Run<RandomIt>> slices;
+        slices.reserve(runs.size());
+        for (size_t r = 0; r < runs.size(); ++r) {
+            slices.emplace_back(runs[r].first + bounds[t][r], runs[r].first + bounds[t + 1][r]);
+        }
+        size_t first = total * t / threads;
+        mergeRuns(slices, out + first, total * (t + 1) / threads - first, key, before);
+    };
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t) {
+        workers.emplace_back(merge, t);
+    }
+    merge(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    return out + total;
+}
+}
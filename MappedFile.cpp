@@ -0,0 +1,59 @@
+#include "MappedFile.hpp"
+
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Maps the file at <path>.
+ *
+ * @throws std::runtime_error if the file cannot be opened or mapped.
+ */
+MappedFile::MappedFile(const std::string& path)
+    : data_ { nullptr }
+    , bytes_ { 0 }
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open " + path + ".");
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Unable to stat " + path + ".");
+    }
+    bytes_ = static_cast<size_t>(info.st_size);
+    if (bytes_ == 0) {
+        ::close(fd);
+        return;
+    }
+
+    void* mapping = ::mmap(nullptr, bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Unable to map " + path + ".");
+    }
+    data_ = static_cast<const char*>(mapping);
+}
+
+MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+        ::munmap(const_cast<char*>(data_), bytes_);
+    }
+}
+
+/**
+ * @brief Returns the first byte of the mapping.
+ */
+const char* MappedFile::data() const {
+    return data_;
+}
+
+/**
+ * @brief Returns the length of the mapping, in bytes.
+ */
+size_t MappedFile::size() const {
+    return bytes_;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+
+/**
+ * @brief A read-only memory mapping of an entire file.
+ *
+ * The mapping is created with a single mmap() on construction & released
+ * on destruction. Empty files map to a null, zero-length region.
+ */
+class MappedFile {
+private:
+    const char* data_;
+    size_t bytes_;
+
+public:
+    /**
+     * @brief Maps the file at <path>.
+     *
+     * @throws std::runtime_error if the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Returns the first byte of the mapping.
+     */
+    const char* data() const;
+
+    /**
+     * @brief Returns the length of the mapping, in bytes.
+     */
+    size_t size() const;
+};
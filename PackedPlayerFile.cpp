@@ -0,0 +1,475 @@
+#include "PackedPlayerFile.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define PACKED_HAVE_AVX2 1
+#endif
+
+namespace {
+const char MAGIC[8] = { 'R', 'N', 'K', 'P', 'A', 'C', 'K', '1' };
+
+void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/**
+ * @brief A bounds-checked reader over a region of the mapped archive.
+ */
+class Reader {
+private:
+    const char* p_;
+    const char* end_;
+
+public:
+    Reader(const char* begin, const char* end)
+        : p_ { begin }
+        , end_ { end }
+    {
+    }
+
+    const char* take(size_t bytes) {
+        if (static_cast<size_t>(end_ - p_) < bytes) {
+            throw std::runtime_error("Corrupt packed player file.");
+        }
+        const char* begin = p_;
+        p_ += bytes;
+        return begin;
+    }
+
+    size_t left() const {
+        return static_cast<size_t>(end_ - p_);
+    }
+
+    template <typename T>
+    T fixed() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = static_cast<uint8_t>(*take(1));
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw std::runtime_error("Corrupt packed player file.");
+    }
+};
+
+/**
+ * @brief Unpacks <count> values of <width> bits from <words> & adds <base>.
+ *
+ * @pre <words> holds at least one word past the last packed bit.
+ */
+void unpackScalar(const uint64_t* words, size_t first, size_t count, unsigned width, uint64_t base, uint64_t* out) {
+    uint64_t mask = width == 64 ? ~0ULL : (1ULL << width) - 1;
+    for (size_t i = first; i < count; ++i) {
+        size_t bit = i * width;
+        size_t word = bit / 64;
+        unsigned shift = bit % 64;
+        // The high word contributes (hi << (64 - shift)), written to stay defined at shift 0
+        uint64_t value = (words[word] >> shift) | ((words[word + 1] << 1) << (63 - shift));
+        out[i] = (value & mask) + base;
+    }
+}
+
+#ifdef PACKED_HAVE_AVX2
+/**
+ * @brief An AVX2 version of unpackScalar(), unpacking 4 values per iteration
+ * with two gathers & a pair of variable shifts. AVX2 shifts by 64 yield 0,
+ * so no special case is needed for values that sit within a single word.
+ */
+__attribute__((target("avx2"))) void unpackAvx2(const uint64_t* words, size_t count, unsigned width, uint64_t base, uint64_t* out) {
+    const __m256i mask = _mm256_set1_epi64x(width == 64 ? ~0LL : static_cast<long long>((1ULL << width) - 1));
+    const __m256i bases = _mm256_set1_epi64x(static_cast<long long>(base));
+    const __m256i sixtyFour = _mm256_set1_epi64x(64);
+    const __m256i lowBits = _mm256_set1_epi64x(63);
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i step = _mm256_set1_epi64x(4LL * width);
+    __m256i bits = _mm256_set_epi64x(3LL * width, 2LL * width, width, 0);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i index = _mm256_srli_epi64(bits, 6);
+        __m256i shift = _mm256_and_si256(bits, lowBits);
+        __m256i low = _mm256_i64gather_epi64(reinterpret_cast<const long long*>(words), index, 8);
+        __m256i high = _mm256_i64gather_epi64(reinterpret_cast<const long long*>(words), _mm256_add_epi64(index, one), 8);
+        __m256i value = _mm256_or_si256(_mm256_srlv_epi64(low, shift), _mm256_sllv_epi64(high, _mm256_sub_epi64(sixtyFour, shift)));
+        value = _mm256_add_epi64(_mm256_and_si256(value, mask), bases);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), value);
+        bits = _mm256_add_epi64(bits, step);
+    }
+    unpackScalar(words, i, count, width, base, out);
+}
+#endif
+
+void unpack(const uint64_t* words, size_t count, unsigned width, uint64_t base, uint64_t* out) {
+    if (width == 0) {
+        std::fill(out, out + count, base);
+        return;
+    }
+#ifdef PACKED_HAVE_AVX2
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2) {
+        unpackAvx2(words, count, width, base, out);
+        return;
+    }
+#endif
+    unpackScalar(words, 0, count, width, base, out);
+}
+
+/**
+ * @brief Accumulates Players into blocks & writes them out as they fill.
+ */
+class PackedWriter {
+private:
+    std::ofstream out_;
+    size_t blockSize_;
+    std::vector<Player> block_;
+    std::unordered_map<std::string, uint64_t> dictionary_;
+    std::vector<const std::string*> names_;
+    std::vector<uint64_t> blockOffsets_;
+    uint64_t count_;
+    std::string scratch_;
+
+    void write(const void* data, size_t bytes) {
+        out_.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    }
+
+    void flushBlock() {
+        if (block_.empty()) {
+            return;
+        }
+        blockOffsets_.push_back(static_cast<uint64_t>(out_.tellp()));
+
+        uint64_t base = block_.front().level_;
+        uint64_t top = base;
+        for (const Player& player : block_) {
+            base = std::min<uint64_t>(base, player.level_);
+            top = std::max<uint64_t>(top, player.level_);
+        }
+        uint8_t width = top == base ? 0 : static_cast<uint8_t>(64 - __builtin_clzll(top - base));
+
+        // Frame of reference + bit-packing for levels
+        std::vector<uint64_t> words((block_.size() * width + 63) / 64, 0);
+        for (size_t i = 0; i < block_.size() && width > 0; ++i) {
+            uint64_t value = block_[i].level_ - base;
+            size_t bit = i * width;
+            unsigned shift = bit % 64;
+            words[bit / 64] |= value << shift;
+            if (shift + width > 64) {
+                words[bit / 64 + 1] |= value >> (64 - shift);
+            }
+        }
+
+        // Zigzag varint deltas for ids, varint dictionary indices for names
+        scratch_.clear();
+        uint64_t previous = 0;
+        for (const Player& player : block_) {
+            putVarint(scratch_, zigzag(static_cast<int64_t>(player.id_ - previous)));
+            previous = player.id_;
+        }
+        uint32_t idBytes = static_cast<uint32_t>(scratch_.size());
+        for (const Player& player : block_) {
+            auto inserted = dictionary_.emplace(player.name_, names_.size());
+            if (inserted.second) {
+                names_.push_back(&inserted.first->first);
+            }
+            putVarint(scratch_, inserted.first->second);
+        }
+        uint32_t nameBytes = static_cast<uint32_t>(scratch_.size()) - idBytes;
+
+        uint32_t count = static_cast<uint32_t>(block_.size());
+        uint32_t wordCount = static_cast<uint32_t>(words.size());
+        write(&count, sizeof(count));
+        write(&width, sizeof(width));
+        write(&base, sizeof(base));
+        write(&wordCount, sizeof(wordCount));
+        write(&idBytes, sizeof(idBytes));
+        write(&nameBytes, sizeof(nameBytes));
+        write(words.data(), words.size() * sizeof(uint64_t));
+        write(scratch_.data(), scratch_.size());
+
+        block_.clear();
+    }
+
+public:
+    PackedWriter(const std::string& path, size_t blockSize)
+        : out_ { path, std::ios::binary | std::ios::trunc }
+        , blockSize_ { std::max<size_t>(1, blockSize) }
+        , count_ { 0 }
+    {
+        if (!out_) {
+            throw std::runtime_error("Unable to open " + path + " for writing.");
+        }
+        PackedFileHeader header {};
+        write(&header, sizeof(header));
+        block_.reserve(blockSize_);
+    }
+
+    void push(Player player) {
+        block_.push_back(std::move(player));
+        count_++;
+        if (block_.size() == blockSize_) {
+            flushBlock();
+        }
+    }
+
+    void finish(const std::string& path) {
+        flushBlock();
+
+        PackedFileHeader header {};
+        std::memcpy(header.magic_, MAGIC, sizeof(MAGIC));
+        header.count_ = count_;
+        header.blockSize_ = blockSize_;
+        header.blockCount_ = blockOffsets_.size();
+
+        header.dictionaryOffset_ = static_cast<uint64_t>(out_.tellp());
+        scratch_.clear();
+        putVarint(scratch_, names_.size());
+        for (const std::string* name : names_) {
+            putVarint(scratch_, name->size());
+            scratch_ += *name;
+        }
+        write(scratch_.data(), scratch_.size());
+
+        header.indexOffset_ = static_cast<uint64_t>(out_.tellp());
+        write(blockOffsets_.data(), blockOffsets_.size() * sizeof(uint64_t));
+
+        out_.seekp(0);
+        write(&header, sizeof(header));
+        if (!out_) {
+            throw std::runtime_error("Failed writing packed player file " + path + ".");
+        }
+    }
+};
+}
+
+/**
+ * @brief Archives every remaining Player of <stream> to <path>.
+ *
+ * Only one block & the name dictionary are held in memory at a time.
+ *
+ * @param path The file to create (or truncate)
+ * @param stream The Players to archive, in order
+ * @param blockSize The number of Players per block
+ * @throws std::runtime_error if the file cannot be written.
+ * @post All elements of the stream are read until there are none remaining.
+ */
+void writePackedPlayerFile(const std::string& path, PlayerStream& stream, size_t blockSize) {
+    PackedWriter writer(path, blockSize);
+    while (stream.remaining() > 0) {
+        writer.push(stream.nextPlayer());
+    }
+    writer.finish(path);
+}
+
+/**
+ * @brief Archives a vector of Players to <path>, in order.
+ */
+void writePackedPlayerFile(const std::string& path, const std::vector<Player>& players, size_t blockSize) {
+    PackedWriter writer(path, blockSize);
+    for (const Player& player : players) {
+        writer.push(player);
+    }
+    writer.finish(path);
+}
+
+/**
+ * @brief Reads & validates the header at the start of [begin, end).
+ *
+ * @throws std::runtime_error if the region does not start with a valid header.
+ */
+PackedFileHeader Packed::readHeader(const char* begin, const char* end) {
+    Reader reader(begin, end);
+    PackedFileHeader header = reader.fixed<PackedFileHeader>();
+    if (std::memcmp(header.magic_, MAGIC, sizeof(MAGIC)) != 0 || header.dictionaryOffset_ > header.indexOffset_) {
+        throw std::runtime_error("Not a valid packed player file.");
+    }
+    return header;
+}
+
+/**
+ * @brief Reads the name dictionary & block index, given the bytes of the
+ * archive from header.dictionaryOffset_ to its end.
+ *
+ * @throws std::runtime_error if the region is corrupt.
+ */
+void Packed::readDirectory(const PackedFileHeader& header, const char* begin, const char* end,
+    std::vector<std::string_view>& names, std::vector<uint64_t>& blockOffsets)
+{
+    uint64_t dictionaryBytes = header.indexOffset_ - header.dictionaryOffset_;
+    if (static_cast<uint64_t>(end - begin) < dictionaryBytes) {
+        throw std::runtime_error("Corrupt packed player file.");
+    }
+
+    Reader dictionary(begin, begin + dictionaryBytes);
+    uint64_t entries = dictionary.varint();
+    names.reserve(std::min(entries, dictionaryBytes)); // Every entry takes at least a byte
+    for (uint64_t i = 0; i < entries; ++i) {
+        uint64_t length = dictionary.varint();
+        names.emplace_back(dictionary.take(length), length);
+    }
+
+    Reader index(begin + dictionaryBytes, end);
+    for (uint64_t i = 0; i < header.blockCount_; ++i) {
+        uint64_t offset = index.fixed<uint64_t>();
+        if (offset > header.dictionaryOffset_) {
+            throw std::runtime_error("Corrupt packed player file.");
+        }
+        blockOffsets.push_back(offset);
+    }
+}
+
+/**
+ * @brief Decodes the block occupying (at most) [begin, end) into <block>.
+ *
+ * The block header is checked against the bytes present before anything is
+ * allocated, so a corrupt header cannot ask for more memory than the block
+ * itself occupies.
+ *
+ * @param blockSize The archive's maximum number of Players per block
+ * @param dictionarySize The number of names in the archive's dictionary
+ * @throws std::runtime_error if the block is corrupt.
+ */
+void Packed::decodeBlock(const char* begin, const char* end, uint64_t blockSize, size_t dictionarySize, Packed::Block& block) {
+    Reader reader(begin, end);
+
+    uint32_t count = reader.fixed<uint32_t>();
+    uint8_t width = reader.fixed<uint8_t>();
+    uint64_t base = reader.fixed<uint64_t>();
+    uint32_t wordCount = reader.fixed<uint32_t>();
+    uint32_t idBytes = reader.fixed<uint32_t>();
+    uint32_t nameBytes = reader.fixed<uint32_t>();
+    if (count == 0 || count > blockSize || width > 64 || wordCount < (static_cast<uint64_t>(count) * width + 63) / 64) {
+        throw std::runtime_error("Corrupt packed player file.");
+    }
+
+    // Every row takes at least one varint byte of ids & one of names
+    uint64_t bodyBytes = static_cast<uint64_t>(wordCount) * sizeof(uint64_t) + idBytes + nameBytes;
+    if (bodyBytes > reader.left() || idBytes < count || nameBytes < count) {
+        throw std::runtime_error("Corrupt packed player file.");
+    }
+
+    // Copy the packed words out with one spare word, so unpacking can always read word + 1
+    block.words_.assign(wordCount + 1, 0);
+    std::memcpy(block.words_.data(), reader.take(wordCount * sizeof(uint64_t)), wordCount * sizeof(uint64_t));
+    block.levels_.resize(count);
+    unpack(block.words_.data(), count, width, base, block.levels_.data());
+
+    const char* idBegin = reader.take(idBytes);
+    Reader ids(idBegin, idBegin + idBytes);
+    block.ids_.resize(count);
+    uint64_t previous = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        previous += static_cast<uint64_t>(unzigzag(ids.varint()));
+        block.ids_[i] = previous;
+    }
+
+    const char* nameBegin = reader.take(nameBytes);
+    Reader names(nameBegin, nameBegin + nameBytes);
+    block.nameRefs_.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        block.nameRefs_[i] = names.varint();
+        if (block.nameRefs_[i] >= dictionarySize) {
+            throw std::runtime_error("Corrupt packed player file.");
+        }
+    }
+}
+
+/**
+ * @brief Retrieves the next Player in the stream.
+ *
+ * @throws std::runtime_error If there are no more players remaining in the
+ *      stream, or the archive cannot be read or is corrupt.
+ */
+Player Packed::BlockStream::nextPlayer() {
+    if (remaining_ == 0) {
+        throw std::runtime_error("No more players remaining in the stream.");
+    }
+    size_t row = nextRow();
+    Player player(std::string(names_[block_.nameRefs_[row]]), block_.levels_[row]);
+    player.id_ = block_.ids_[row];
+    remaining_--;
+    return player;
+}
+
+/**
+ * @brief Returns the number of players remaining in the stream.
+ */
+size_t Packed::BlockStream::remaining() const {
+    return remaining_;
+}
+
+/**
+ * @brief Decodes up to <maxPlayers> Players into <batch>, overwriting its
+ * existing elements in place.
+ *
+ * @return The number of Players decoded; <batch> is resized to match.
+ */
+size_t Packed::BlockStream::nextBatch(std::vector<Player>& batch, size_t maxPlayers) {
+    size_t count = std::min(maxPlayers, remaining_);
+    batch.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t row = nextRow();
+        batch[i].name_.assign(names_[block_.nameRefs_[row]]);
+        batch[i].level_ = block_.levels_[row];
+        batch[i].id_ = block_.ids_[row];
+    }
+    remaining_ -= count;
+    return count;
+}
+
+/**
+ * @brief Opens the archive at <path>, reading its dictionary & block index.
+ *
+ * @throws std::runtime_error if the file cannot be mapped or is not a
+ *      valid archive.
+ */
+PackedPlayerStream::PackedPlayerStream(const std::string& path)
+    : file_ { path }
+    , nextBlock_ { 0 }
+{
+    const char* begin = file_.data();
+    const char* end = begin + file_.size();
+
+    header_ = Packed::readHeader(begin, end);
+    if (header_.indexOffset_ > file_.size()) {
+        throw std::runtime_error(path + " is not a valid packed player file.");
+    }
+    Packed::readDirectory(header_, begin + header_.dictionaryOffset_, end, names_, blockOffsets_);
+    remaining_ = header_.count_;
+}
+
+/**
+ * @brief Decodes the next block into the level, id & name columns.
+ */
+void PackedPlayerStream::nextBlock() {
+    if (nextBlock_ >= blockOffsets_.size()) {
+        throw std::runtime_error("Corrupt packed player file.");
+    }
+    Packed::decodeBlock(file_.data() + blockOffsets_[nextBlock_++], file_.data() + header_.dictionaryOffset_,
+        header_.blockSize_, names_.size(), block_);
+}
@@ -0,0 +1,189 @@
+#pragma once
+#include "MappedFile.hpp"
+#include "Player.hpp"
+#include "PlayerStream.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief The header of a compressed, block-based archive of a Player stream.
+ *
+ * Players are grouped into blocks of up to blockSize_ Players, each laid out as:
+ *
+ *   uint32_t count, uint8_t bitWidth, uint64_t base,
+ *   uint32_t wordCount, uint32_t idBytes, uint32_t nameBytes,
+ *   uint64_t packed[wordCount] -> levels as (level - base), bitWidth bits each
+ *   char ids[idBytes]          -> zigzag varint deltas from the previous id
+ *   char names[nameBytes]      -> varint indices into the name dictionary
+ *
+ * The blocks are followed by the name dictionary (a varint entry count, then
+ * a varint length & the bytes of each name) & an index of uint64_t block
+ * offsets. All fixed-width integers are stored little-endian.
+ */
+struct PackedFileHeader {
+    char magic_[8];
+    uint64_t count_;
+    uint64_t blockSize_;
+    uint64_t blockCount_;
+    uint64_t dictionaryOffset_;
+    uint64_t indexOffset_;
+};
+
+/**
+ * @brief Decoding helpers shared by every reader of packed archives.
+ */
+namespace Packed {
+/**
+ * @brief The decoded columns of a single block.
+ */
+struct Block {
+    std::vector<uint64_t> levels_;
+    std::vector<uint64_t> ids_;
+    std::vector<uint64_t> nameRefs_;
+    std::vector<uint64_t> words_;
+};
+
+/**
+ * @brief Reads & validates the header at the start of [begin, end).
+ *
+ * @throws std::runtime_error if the region does not start with a valid header.
+ */
+PackedFileHeader readHeader(const char* begin, const char* end);
+
+/**
+ * @brief Reads the name dictionary & block index, given the bytes of the
+ * archive from header.dictionaryOffset_ to its end.
+ *
+ * The names are views into [begin, end), which must outlive them; building
+ * a std::string per entry up front cost more than replaying the archive.
+ *
+ * @throws std::runtime_error if the region is corrupt.
+ */
+void readDirectory(const PackedFileHeader& header, const char* begin, const char* end,
+    std::vector<std::string_view>& names, std::vector<uint64_t>& blockOffsets);
+
+/**
+ * @brief Decodes the block occupying (at most) [begin, end) into <block>.
+ *
+ * @param blockSize The archive's maximum number of Players per block
+ * @param dictionarySize The number of names in the archive's dictionary
+ * @throws std::runtime_error if the block is corrupt, including a header
+ *      claiming no Players, more than <blockSize>, or more bytes than
+ *      [begin, end) holds.
+ */
+void decodeBlock(const char* begin, const char* end, uint64_t blockSize, size_t dictionarySize, Block& block);
+
+/**
+ * @brief The row decoding shared by every PlayerStream over a packed archive.
+ *
+ * Hands out the Players of the current decoded block, asking the reader for
+ * the next block through nextBlock() as each one runs out. Readers differ
+ * only in how they load blocks.
+ */
+class BlockStream : public PlayerStream {
+protected:
+    std::vector<std::string_view> names_; // Into storage the reader keeps alive
+    Block block_;
+    size_t blockIndex_ = 0;
+    size_t remaining_ = 0;
+
+    /**
+     * @brief Decodes the archive's next block into block_.
+     *
+     * @throws std::runtime_error if there is no next block, it cannot be read,
+     *      or it is corrupt.
+     */
+    virtual void nextBlock() = 0;
+
+private:
+    /**
+     * @brief Returns the row of block_ holding the next Player, decoding the
+     * next block first if this one is used up.
+     */
+    size_t nextRow() {
+        if (blockIndex_ >= block_.levels_.size()) {
+            nextBlock();
+            blockIndex_ = 0;
+        }
+        return blockIndex_++;
+    }
+
+public:
+    /**
+     * @brief Retrieves the next Player in the stream.
+     *
+     * @throws std::runtime_error If there are no more players remaining in the
+     *      stream, or the archive cannot be read or is corrupt.
+     */
+    Player nextPlayer() override;
+
+    /**
+     * @brief Returns the number of players remaining in the stream.
+     */
+    size_t remaining() const override;
+
+    /**
+     * @brief Decodes up to <maxPlayers> Players into <batch>, overwriting its
+     * existing elements in place.
+     *
+     * @return The number of Players decoded; <batch> is resized to match.
+     */
+    size_t nextBatch(std::vector<Player>& batch, size_t maxPlayers);
+};
+}
+
+/**
+ * @brief Archives every remaining Player of <stream> to <path>.
+ *
+ * Only one block & the name dictionary are held in memory at a time.
+ *
+ * @param path The file to create (or truncate)
+ * @param stream The Players to archive, in order
+ * @param blockSize The number of Players per block
+ * @throws std::runtime_error if the file cannot be written.
+ * @post All elements of the stream are read until there are none remaining.
+ */
+void writePackedPlayerFile(const std::string& path, PlayerStream& stream, size_t blockSize = 4096);
+
+/**
+ * @brief Archives a vector of Players to <path>, in order.
+ */
+void writePackedPlayerFile(const std::string& path, const std::vector<Player>& players, size_t blockSize = 4096);
+
+/**
+ * @brief A PlayerStream replaying an archive written by writePackedPlayerFile().
+ *
+ * The archive is mapped in a single mmap() & decoded a whole block at a time;
+ * level columns are bit-unpacked 4 at a time with AVX2 gathers & variable
+ * shifts when the CPU supports them.
+ *
+ * @note Replays do not beat a plain read of the uncompressed data. Every
+ *       Player handed out owns a copy of its name, & with unique names the
+ *       dictionary is as large as the names themselves. On 5M uniform
+ *       Players (unique names, from the page cache) a full replay takes
+ *       about 115-165 ms with nextBatch() & 160-220 ms with nextPlayer(),
+ *       against 90-130 ms for MmapPlayerStream over a PlayerFile & 30 ms
+ *       to read() that file. The archive is half the PlayerFile's size, so
+ *       the saving is in I/O, not CPU.
+ */
+class PackedPlayerStream final : public Packed::BlockStream {
+private:
+    MappedFile file_;
+    PackedFileHeader header_;
+    std::vector<uint64_t> blockOffsets_;
+    size_t nextBlock_;
+
+    void nextBlock() override;
+
+public:
+    /**
+     * @brief Opens the archive at <path>, reading its dictionary & block index.
+     *
+     * @throws std::runtime_error if the file cannot be mapped or is not a
+     *      valid archive.
+     */
+    explicit PackedPlayerStream(const std::string& path);
+};
@@ -0,0 +1,119 @@
+#include "PerfCounters.hpp"
+
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+struct EventSpec {
+    uint32_t type_;
+    uint64_t config_;
+    HardwareCounters::Counter counter_;
+    uint64_t HardwareCounters::*field_;
+};
+
+constexpr uint64_t cacheMiss(uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+// Indexed in parallel with PerfCollector::fds_
+const EventSpec EVENTS[PerfCollector::EVENT_COUNT] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, HardwareCounters::Cycles, &HardwareCounters::cycles_ },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, HardwareCounters::Instructions, &HardwareCounters::instructions_ },
+    { PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_L1D), HardwareCounters::L1dMisses, &HardwareCounters::l1dMisses_ },
+    { PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_LL), HardwareCounters::LlcMisses, &HardwareCounters::llcMisses_ },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, HardwareCounters::BranchMisses, &HardwareCounters::branchMisses_ },
+    { PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_DTLB), HardwareCounters::DtlbMisses, &HardwareCounters::dtlbMisses_ },
+};
+
+int openEvent(const EventSpec& spec) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = spec.type_;
+    attr.config = spec.config_;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.inherit = 1; // Include worker threads spawned by the engine
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    // This thread (& threads it spawns), on whichever CPU it runs
+    return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+}
+
+/**
+ * @brief Opens every supported counter selected by <events> for the calling
+ * thread. Counters the kernel refuses are skipped.
+ */
+PerfCollector::PerfCollector(unsigned events) {
+    for (size_t i = 0; i < EVENT_COUNT; ++i) {
+        fds_[i] = (events & EVENTS[i].counter_) != 0 ? openEvent(EVENTS[i]) : -1;
+    }
+}
+
+PerfCollector::~PerfCollector() {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+/**
+ * @brief Returns whether at least one counter could be opened.
+ */
+bool PerfCollector::available() const {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Resets & enables every open counter.
+ */
+void PerfCollector::start() {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+/**
+ * @brief Disables every open counter & returns their counts since start(),
+ * scaled for any time the kernel had them multiplexed out.
+ */
+HardwareCounters PerfCollector::stop() {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    HardwareCounters counters;
+    for (size_t i = 0; i < EVENT_COUNT; ++i) {
+        if (fds_[i] < 0) {
+            continue;
+        }
+        // { value, time enabled, time running }
+        uint64_t values[3];
+        if (::read(fds_[i], values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)) || values[2] == 0) {
+            continue; // Never scheduled onto the PMU
+        }
+        uint64_t count = values[0];
+        if (values[2] < values[1]) {
+            count = static_cast<uint64_t>(static_cast<double>(count) * values[1] / values[2]);
+        }
+        counters.*(EVENTS[i].field_) = count;
+        counters.available_ |= EVENTS[i].counter_;
+    }
+    return counters;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Hardware event counts captured around a ranking call.
+ *
+ * Each counter is only meaningful if its bit is set in available_; counters
+ * the kernel refused to open (eg. perf_event_paranoid, containers, VMs
+ * without a virtual PMU) are left at zero. Counts are scaled up when the
+ * kernel multiplexed the counter for part of the measurement.
+ */
+struct HardwareCounters {
+    enum Counter : unsigned {
+        Cycles = 1u << 0,
+        Instructions = 1u << 1,
+        L1dMisses = 1u << 2,
+        LlcMisses = 1u << 3,
+        BranchMisses = 1u << 4,
+        DtlbMisses = 1u << 5,
+    };
+
+    unsigned available_ = 0;
+    uint64_t cycles_ = 0;
+    uint64_t instructions_ = 0;
+    uint64_t l1dMisses_ = 0;
+    uint64_t llcMisses_ = 0;
+    uint64_t branchMisses_ = 0;
+    uint64_t dtlbMisses_ = 0;
+
+    /**
+     * @brief Returns whether <counter> was captured.
+     */
+    bool has(Counter counter) const { return (available_ & counter) != 0; }
+};
+
+/**
+ * @brief Collects HardwareCounters for the calling thread, & any threads it
+ * spawns while the collector exists, through perf_event_open(2).
+ *
+ * Every event is opened independently on construction (user space only), so
+ * a host exposing some but not all of them still reports what it can. If
+ * none can be opened the collector is simply unavailable: start() & stop()
+ * become no-ops & stop() returns an empty HardwareCounters. It never throws.
+ *
+ * @example
+ *   PerfCollector collector;
+ *   RankingResult result = withCounters(collector, [&] { return Offline::heapRank(players); });
+ *   if (result.counters_.has(HardwareCounters::LlcMisses)) { ... }
+ */
+class PerfCollector {
+public:
+    static constexpr size_t EVENT_COUNT = 6;
+
+private:
+    int fds_[EVENT_COUNT];
+
+public:
+    /**
+     * @brief Opens the counters whose HardwareCounters::Counter bits are set
+     * in <events>; by default every one. A mask of 0 yields an unavailable
+     * collector on any host.
+     */
+    explicit PerfCollector(unsigned events = ~0u);
+    ~PerfCollector();
+
+    PerfCollector(const PerfCollector&) = delete;
+    PerfCollector& operator=(const PerfCollector&) = delete;
+
+    /**
+     * @brief Returns whether at least one counter could be opened.
+     */
+    bool available() const;
+
+    /**
+     * @brief Resets & enables every open counter.
+     */
+    void start();
+
+    /**
+     * @brief Disables every open counter & returns their counts since start().
+     */
+    HardwareCounters stop();
+};
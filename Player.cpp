@@ -3,6 +3,7 @@
 Player::Player(const std::string& name, const size_t& level)
     : name_ { name }
     , level_ { level }
+    , id_ { 0 }
 {}
 
 bool Player::operator<(const Player& rhs) const
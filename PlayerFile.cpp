@@ -0,0 +1,263 @@
+#include "PlayerFile.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+const char MAGIC[8] = { 'R', 'N', 'K', 'P', 'L', 'Y', 'R', '1' };
+const uint64_t ALIGNMENT = 64;
+
+uint64_t alignUp(uint64_t offset) {
+    return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+void writeAt(std::ofstream& out, uint64_t offset, const void* data, size_t bytes) {
+    out.seekp(static_cast<std::streamoff>(offset));
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+}
+
+/**
+ * @brief Returns whether a column of <count> uint64_t at <offset> lies within
+ * a mapping of <bytes> bytes & is aligned for reading in place. Written so
+ * that no crafted offset or count can overflow the arithmetic.
+ */
+bool columnFits(uint64_t offset, uint64_t count, uint64_t bytes) {
+    return offset % alignof(uint64_t) == 0
+        && offset <= bytes
+        && count <= (bytes - offset) / sizeof(uint64_t);
+}
+}
+
+/**
+ * @brief Writes a vector of Players to <path> in the PlayerFileHeader layout.
+ *
+ * @param path The file to create (or truncate)
+ * @param players The Players to write, in order
+ * @throws std::runtime_error if the file cannot be written.
+ */
+void writePlayerFile(const std::string& path, const std::vector<Player>& players) {
+    PlayerFileWriter writer(path, players.size());
+    for (const Player& player : players) {
+        writer.append(player);
+    }
+    writer.finish();
+}
+
+namespace {
+// Players buffered per column before a flush
+const size_t WRITER_BATCH = 1 << 16;
+}
+
+/**
+ * @brief Creates (or truncates) <path> for a roster of exactly <count> Players.
+ *
+ * @throws std::runtime_error if the file cannot be opened.
+ */
+PlayerFileWriter::PlayerFileWriter(const std::string& path, size_t count)
+    : out_ { path, std::ios::binary | std::ios::trunc }
+    , path_ { path }
+    , header_ {}
+    , written_ { 0 }
+    , flushed_ { 0 }
+    , namesSize_ { 0 }
+    , bytes_ { 0 }
+{
+    if (!out_) {
+        throw std::runtime_error("Unable to open " + path + " for writing.");
+    }
+    std::memcpy(header_.magic_, MAGIC, sizeof(MAGIC));
+    header_.count_ = count;
+    header_.levelsOffset_ = alignUp(sizeof(PlayerFileHeader));
+    header_.idsOffset_ = alignUp(header_.levelsOffset_ + count * sizeof(uint64_t));
+    header_.nameOffsetsOffset_ = alignUp(header_.idsOffset_ + count * sizeof(uint64_t));
+    header_.namesOffset_ = alignUp(header_.nameOffsetsOffset_ + (count + 1) * sizeof(uint64_t));
+
+    levels_.reserve(std::min(count, WRITER_BATCH));
+    ids_.reserve(std::min(count, WRITER_BATCH));
+    nameOffsets_.reserve(std::min(count, WRITER_BATCH) + 1);
+}
+
+/**
+ * @brief Appends the next Player.
+ *
+ * @throws std::runtime_error if <count> Players have already been appended.
+ */
+void PlayerFileWriter::append(const Player& player) {
+    if (written_ == header_.count_) {
+        throw std::runtime_error("Too many players written to " + path_ + ".");
+    }
+    levels_.push_back(player.level_);
+    ids_.push_back(player.id_);
+    nameOffsets_.push_back(namesSize_ + names_.size());
+    names_ += player.name_;
+    written_++;
+
+    if (levels_.size() == WRITER_BATCH) {
+        flush();
+    }
+}
+
+/**
+ * @brief Writes the buffered rows to their sections.
+ */
+void PlayerFileWriter::flush() {
+    size_t rows = levels_.size();
+    writeAt(out_, header_.levelsOffset_ + flushed_ * sizeof(uint64_t), levels_.data(), rows * sizeof(uint64_t));
+    writeAt(out_, header_.idsOffset_ + flushed_ * sizeof(uint64_t), ids_.data(), rows * sizeof(uint64_t));
+    writeAt(out_, header_.nameOffsetsOffset_ + flushed_ * sizeof(uint64_t), nameOffsets_.data(), nameOffsets_.size() * sizeof(uint64_t));
+    writeAt(out_, header_.namesOffset_ + namesSize_, names_.data(), names_.size());
+    bytes_ += (2 * rows + nameOffsets_.size()) * sizeof(uint64_t) + names_.size();
+
+    flushed_ += rows;
+    namesSize_ += names_.size();
+    levels_.clear();
+    ids_.clear();
+    nameOffsets_.clear();
+    names_.clear();
+}
+
+/**
+ * @brief Flushes every section & writes the header.
+ *
+ * @throws std::runtime_error if fewer than <count> Players were appended
+ *      or the file could not be written.
+ */
+void PlayerFileWriter::finish() {
+    if (written_ != header_.count_) {
+        throw std::runtime_error("Too few players written to " + path_ + ".");
+    }
+    flush();
+
+    // An empty blob still has to start inside the file. Padding written here
+    // is overwritten by the closing name offset if the two overlap.
+    if (namesSize_ == 0) {
+        char pad = 0;
+        writeAt(out_, header_.namesOffset_ - 1, &pad, sizeof(pad));
+    }
+
+    // The closing name offset, then the header now that the blob size is known
+    uint64_t end = namesSize_;
+    writeAt(out_, header_.nameOffsetsOffset_ + header_.count_ * sizeof(uint64_t), &end, sizeof(end));
+    header_.namesSize_ = namesSize_;
+    writeAt(out_, 0, &header_, sizeof(header_));
+    bytes_ += sizeof(end) + sizeof(header_);
+
+    out_.flush();
+    if (!out_) {
+        throw std::runtime_error("Failed writing player file " + path_ + ".");
+    }
+}
+
+/**
+ * @brief Returns the number of bytes written to the file so far.
+ */
+size_t PlayerFileWriter::bytesWritten() const {
+    return bytes_;
+}
+
+/**
+ * @brief Maps the roster file at <path>.
+ *
+ * @throws std::runtime_error if the file cannot be mapped or is not a
+ *      valid roster file.
+ */
+PlayerFile::PlayerFile(const std::string& path)
+    : mapping_ { path }
+    , data_ { mapping_.data() }
+    , header_ { reinterpret_cast<const PlayerFileHeader*>(mapping_.data()) }
+{
+    size_t bytes = mapping_.size();
+    if (bytes < sizeof(PlayerFileHeader)) {
+        throw std::runtime_error(path + " is not a player file.");
+    }
+
+    // Reject anything whose sections would fall outside the mapping
+    uint64_t count = header_->count_;
+    bool valid = std::memcmp(header_->magic_, MAGIC, sizeof(MAGIC)) == 0
+        && count < bytes / sizeof(uint64_t)
+        && columnFits(header_->levelsOffset_, count, bytes)
+        && columnFits(header_->idsOffset_, count, bytes)
+        && columnFits(header_->nameOffsetsOffset_, count + 1, bytes)
+        && header_->namesOffset_ <= bytes
+        && header_->namesSize_ <= bytes - header_->namesOffset_;
+    if (!valid) {
+        throw std::runtime_error(path + " is not a valid player file.");
+    }
+}
+
+/**
+ * @brief Returns the number of Players in the file.
+ */
+size_t PlayerFile::size() const {
+    return header_->count_;
+}
+
+/**
+ * @brief Returns the mapped level column, of length size().
+ */
+const uint64_t* PlayerFile::levels() const {
+    return reinterpret_cast<const uint64_t*>(data_ + header_->levelsOffset_);
+}
+
+/**
+ * @brief Returns the level column as a single LevelColumn.
+ */
+std::vector<LevelColumn> PlayerFile::levelColumns() const {
+    return { LevelColumn { levels(), size(), 0 } };
+}
+
+/**
+ * @brief Returns the mapped id column, of length size().
+ */
+const uint64_t* PlayerFile::ids() const {
+    return reinterpret_cast<const uint64_t*>(data_ + header_->idsOffset_);
+}
+
+/**
+ * @brief Returns a view of the i-th Player's name within the mapping.
+ */
+std::string_view PlayerFile::name(size_t i) const {
+    const uint64_t* offsets = reinterpret_cast<const uint64_t*>(data_ + header_->nameOffsetsOffset_);
+    uint64_t begin = std::min(offsets[i], header_->namesSize_);
+    uint64_t end = std::min(std::max(offsets[i + 1], begin), header_->namesSize_);
+    return std::string_view(data_ + header_->namesOffset_ + begin, end - begin);
+}
+
+/**
+ * @brief Materializes the i-th Player of the file.
+ */
+Player PlayerFile::player(size_t i) const {
+    Player player(std::string(name(i)), levels()[i]);
+    player.id_ = ids()[i];
+    return player;
+}
+
+/**
+ * @brief Constructs a stream over every Player of <file>, in order.
+ */
+MmapPlayerStream::MmapPlayerStream(const PlayerFile& file)
+    : file_ { file }
+    , currentIndex_ { 0 }
+{
+}
+
+/**
+ * @brief Retrieves the next Player in the stream.
+ *
+ * @throws std::runtime_error If there are no more players remaining in the stream.
+ */
+Player MmapPlayerStream::nextPlayer() {
+    if (currentIndex_ >= file_.size()) {
+        throw std::runtime_error("No more players remaining in the stream.");
+    }
+    return file_.player(currentIndex_++);
+}
+
+/**
+ * @brief Returns the number of players remaining in the stream.
+ */
+size_t MmapPlayerStream::remaining() const {
+    return file_.size() - currentIndex_;
+}
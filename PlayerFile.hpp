@@ -0,0 +1,189 @@
+#pragma once
+#include "MappedFile.hpp"
+#include "Player.hpp"
+#include "PlayerStream.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief The on-disk layout of a binary, columnar roster of Players.
+ *
+ * All integers are stored in the host's (little-endian) byte order & every
+ * section starts on a 64-byte boundary, so the columns can be used in place
+ * straight out of a memory mapping:
+ *
+ *   [ PlayerFileHeader                                    ]
+ *   [ levels       : uint64_t[count]                      ]
+ *   [ ids          : uint64_t[count]                      ]
+ *   [ name offsets : uint64_t[count + 1], into the blob   ]
+ *   [ name blob    : char[namesSize], no terminators      ]
+ *
+ * The name of player i spans [nameOffsets[i], nameOffsets[i + 1]) of the blob.
+ */
+struct PlayerFileHeader {
+    char magic_[8];
+    uint64_t count_;
+    uint64_t levelsOffset_;
+    uint64_t idsOffset_;
+    uint64_t nameOffsetsOffset_;
+    uint64_t namesOffset_;
+    uint64_t namesSize_;
+    uint64_t reserved_;
+};
+
+/**
+ * @brief A contiguous run of a columnar roster's level column, holding the
+ * levels of rows [firstRow_, firstRow_ + size_).
+ */
+struct LevelColumn {
+    const uint64_t* levels_;
+    size_t size_;
+    size_t firstRow_;
+};
+
+/**
+ * @brief Writes a vector of Players to <path> in the PlayerFileHeader layout.
+ *
+ * @param path The file to create (or truncate)
+ * @param players The Players to write, in order
+ * @throws std::runtime_error if the file cannot be written.
+ */
+void writePlayerFile(const std::string& path, const std::vector<Player>& players);
+
+/**
+ * @brief Writes a roster file incrementally, one Player at a time, so rosters
+ * larger than memory can be written.
+ *
+ * The Player count must be known up front, since it fixes where each
+ * section starts; each column is buffered & flushed to its own section as
+ * it fills.
+ */
+class PlayerFileWriter {
+private:
+    std::ofstream out_;
+    std::string path_;
+    PlayerFileHeader header_;
+    size_t written_;
+    size_t flushed_;
+    uint64_t namesSize_;
+    std::vector<uint64_t> levels_;
+    std::vector<uint64_t> ids_;
+    std::vector<uint64_t> nameOffsets_;
+    std::string names_;
+    size_t bytes_;
+
+    void flush();
+
+public:
+    /**
+     * @brief Creates (or truncates) <path> for a roster of exactly <count> Players.
+     *
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    PlayerFileWriter(const std::string& path, size_t count);
+
+    /**
+     * @brief Appends the next Player.
+     *
+     * @throws std::runtime_error if <count> Players have already been appended.
+     */
+    void append(const Player& player);
+
+    /**
+     * @brief Flushes every section & writes the header.
+     *
+     * @throws std::runtime_error if fewer than <count> Players were appended
+     *      or the file could not be written.
+     */
+    void finish();
+
+    /**
+     * @brief Returns the number of bytes written to the file so far.
+     */
+    size_t bytesWritten() const;
+};
+
+/**
+ * @brief A read-only memory mapping of a binary roster file.
+ *
+ * Opening a file is a single mmap() plus header validation; no column is
+ * parsed or copied. The mapping is released when the PlayerFile is destroyed.
+ */
+class PlayerFile {
+private:
+    MappedFile mapping_;
+    const char* data_;
+    const PlayerFileHeader* header_;
+
+public:
+    /**
+     * @brief Maps the roster file at <path>.
+     *
+     * @throws std::runtime_error if the file cannot be mapped or is not a
+     *      valid roster file.
+     */
+    explicit PlayerFile(const std::string& path);
+
+    /**
+     * @brief Returns the number of Players in the file.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the mapped level column, of length size().
+     */
+    const uint64_t* levels() const;
+
+    /**
+     * @brief Returns the level column as a single LevelColumn.
+     */
+    std::vector<LevelColumn> levelColumns() const;
+
+    /**
+     * @brief Returns the mapped id column, of length size().
+     */
+    const uint64_t* ids() const;
+
+    /**
+     * @brief Returns a view of the i-th Player's name within the mapping.
+     */
+    std::string_view name(size_t i) const;
+
+    /**
+     * @brief Materializes the i-th Player of the file.
+     */
+    Player player(size_t i) const;
+};
+
+/**
+ * @brief A PlayerStream reading Players straight out of a mapped roster file.
+ *
+ * The stream does not own the mapping; <file> must outlive it.
+ */
+class MmapPlayerStream final : public PlayerStream {
+private:
+    const PlayerFile& file_;
+    size_t currentIndex_;
+
+public:
+    /**
+     * @brief Constructs a stream over every Player of <file>, in order.
+     */
+    explicit MmapPlayerStream(const PlayerFile& file);
+
+    /**
+     * @brief Retrieves the next Player in the stream.
+     *
+     * @throws std::runtime_error If there are no more players remaining in the stream.
+     */
+    Player nextPlayer() override;
+
+    /**
+     * @brief Returns the number of players remaining in the stream.
+     */
+    size_t remaining() const override;
+};
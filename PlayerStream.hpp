@@ -67,10 +67,19 @@ public:
      */
     VectorPlayerStream(const std::vector<Player>& players);
 
+    /**
+     * @brief Constructs a VectorPlayerStream that takes ownership of a vector
+     * of Players without copying it.
+     *
+     * @param players The vector of Player objects to stream, moved from.
+     */
+    VectorPlayerStream(std::vector<Player>&& players);
+
     /**
     * @brief Retrieves the next Player in the stream.
     *
-    * @return The next Player object in the sequence.
+    * @return The next Player object in the sequence, moved out of the stream
+    * (each Player is only ever handed out once).
     * @post Updates members so a subsequent call to nextPlayer() yields the Player
     * following that which is returned.
 
@@ -84,4 +93,91 @@ public:
      * @return The count of players left to be read.
      */
     size_t remaining() const override; // see how many instances remaining to be fetched
-};
\ No newline at end of file
+};
+
+/**
+ * @brief A non-owning PlayerStream over a contiguous range of Players.
+ *
+ * Nothing is copied on construction; the range must outlive the stream.
+ * Consumers that only need to inspect each Player can call nextPlayerRef()
+ * & copy just the ones they keep.
+ *
+ * @example Given a vector v, PlayerSpanStream(v.data(), v.data() + v.size())
+ * streams the contents of v in order without copying it.
+ */
+class PlayerSpanStream final : public PlayerStream {
+private:
+    const Player* current_;
+    const Player* last_;
+
+public:
+    /**
+     * @brief Constructs a stream over the range [first, last).
+     */
+    PlayerSpanStream(const Player* first, const Player* last);
+
+    /**
+     * @brief Constructs a stream over the contents of <players>.
+     */
+    explicit PlayerSpanStream(const std::vector<Player>& players);
+
+    // A temporary vector would be destroyed before the stream is read
+    PlayerSpanStream(std::vector<Player>&&) = delete;
+
+    /**
+     * @brief Retrieves a copy of the next Player in the stream.
+     *
+     * @throws std::runtime_error If there are no more players remaining in the stream.
+     */
+    Player nextPlayer() override;
+
+    /**
+     * @brief Retrieves a reference to the next Player in the stream, which
+     * remains valid for as long as the underlying range does.
+     *
+     * @throws std::runtime_error If there are no more players remaining in the stream.
+     */
+    const Player& nextPlayerRef();
+
+    /**
+     * @brief Returns the number of players remaining in the stream.
+     */
+    size_t remaining() const override;
+};
+
+/*
+ * nextPlayer() & remaining() are defined inline so that callers holding a
+ * stream directly, such as the templated Online::rankIncoming(), can inline
+ * them. Only PlayerSpanStream is final, so only its calls are devirtualized;
+ * VectorPlayerStream stays open to subclassing.
+ */
+inline Player VectorPlayerStream::nextPlayer()
+{
+    if (currentIndex_ >= players_.size())
+    {
+        throw std::runtime_error("No more players remaining in the stream.");
+    }
+    return std::move(players_[currentIndex_++]);
+}
+
+inline size_t VectorPlayerStream::remaining() const {
+    return players_.size() - currentIndex_;
+}
+
+inline const Player& PlayerSpanStream::nextPlayerRef()
+{
+    if (current_ == last_)
+    {
+        throw std::runtime_error("No more players remaining in the stream.");
+    }
+    return *current_++;
+}
+
+inline Player PlayerSpanStream::nextPlayer()
+{
+    return nextPlayerRef();
+}
+
+inline size_t PlayerSpanStream::remaining() const {
+    return static_cast<size_t>(last_ - current_);
+}
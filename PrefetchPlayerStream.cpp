@@ -0,0 +1,472 @@
+#include "PrefetchPlayerStream.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <fcntl.h>
+#include <mutex>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+/**
+ * @brief Loads buffers of the archive, in order, ahead of their use.
+ */
+class PrefetchPlayerStream::Prefetcher {
+public:
+    virtual ~Prefetcher() = default;
+
+    /**
+     * @brief Blocks until unit <index> has been read, & returns its buffer.
+     *
+     * @pre Units are acquired in increasing order, one at a time. Acquiring
+     *      unit i releases the buffer of unit i - 1 for reuse.
+     * @throws std::runtime_error if the read of unit <index> failed. A failed
+     *      read of a later unit is only thrown once that unit is acquired.
+     */
+    virtual const std::vector<char>& acquire(size_t index) = 0;
+
+    /**
+     * @brief Returns whether reads are being issued through io_uring.
+     */
+    virtual bool usingIoUring() const = 0;
+};
+
+namespace {
+using ReadUnit = PrefetchPlayerStream::ReadUnit;
+
+/**
+ * @brief Reads exactly <bytes> bytes at <offset>, retrying short reads.
+ *
+ * @throws std::runtime_error on error or a premature end of file.
+ */
+void readFully(int fd, char* buffer, size_t bytes, uint64_t offset) {
+    while (bytes > 0) {
+        ssize_t got = ::pread(fd, buffer, bytes, static_cast<off_t>(offset));
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            throw std::runtime_error("Failed reading packed player file.");
+        }
+        buffer += got;
+        bytes -= static_cast<size_t>(got);
+        offset += static_cast<uint64_t>(got);
+    }
+}
+
+/**
+ * @brief Prefetches on a background thread issuing pread()s.
+ */
+class ThreadPrefetcher : public PrefetchPlayerStream::Prefetcher {
+private:
+    int fd_;
+    const std::vector<ReadUnit>& units_;
+    size_t depth_;
+    std::vector<std::vector<char>> buffers_;
+    std::vector<size_t> loaded_;
+    size_t released_;
+    bool stop_;
+    size_t failedUnit_; // The unit whose read failed, or SIZE_MAX
+    std::exception_ptr error_;
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::thread worker_;
+
+    void run() {
+        for (size_t unit = 0; unit < units_.size(); ++unit) {
+            size_t slot = unit % depth_;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                changed_.wait(lock, [&]() { return stop_ || unit < released_ + depth_; });
+                if (stop_) {
+                    return;
+                }
+            }
+
+            // The slot is free until we publish it, so read without the lock
+            std::exception_ptr error;
+            try {
+                buffers_[slot].resize(units_[unit].bytes_);
+                readFully(fd_, buffers_[slot].data(), units_[unit].bytes_, units_[unit].offset_);
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            changed_.notify_all();
+            if (error) {
+                // Units before this one are still handed out; reading stops here
+                failedUnit_ = unit;
+                error_ = error;
+                return;
+            }
+            loaded_[slot] = unit;
+        }
+    }
+
+public:
+    ThreadPrefetcher(int fd, const std::vector<ReadUnit>& units, size_t depth)
+        : fd_ { fd }
+        , units_ { units }
+        , depth_ { depth }
+        , buffers_(depth)
+        , loaded_(depth, SIZE_MAX)
+        , released_ { 0 }
+        , stop_ { false }
+        , failedUnit_ { SIZE_MAX }
+        , worker_ { &ThreadPrefetcher::run, this }
+    {
+    }
+
+    ~ThreadPrefetcher() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        changed_.notify_all();
+        worker_.join();
+    }
+
+    const std::vector<char>& acquire(size_t index) override {
+        size_t slot = index % depth_;
+        std::unique_lock<std::mutex> lock(mutex_);
+        released_ = index;
+        changed_.notify_all();
+        changed_.wait(lock, [&]() { return loaded_[slot] == index || failedUnit_ <= index; });
+        if (loaded_[slot] != index) {
+            std::rethrow_exception(error_);
+        }
+        return buffers_[slot];
+    }
+
+    bool usingIoUring() const override {
+        return false;
+    }
+};
+
+#ifdef __linux__
+/**
+ * @brief Prefetches through an io_uring instance driven by raw syscalls,
+ * keeping up to <depth> READV requests in flight.
+ */
+class UringPrefetcher : public PrefetchPlayerStream::Prefetcher {
+private:
+    int ring_;
+    void* sqRing_;
+    size_t sqRingBytes_;
+    void* cqRing_;
+    size_t cqRingBytes_;
+    io_uring_sqe* sqes_;
+    size_t sqesBytes_;
+
+    unsigned* sqTail_;
+    unsigned* sqMask_;
+    unsigned* sqArray_;
+    unsigned* cqHead_;
+    unsigned* cqTail_;
+    unsigned* cqMask_;
+    io_uring_cqe* cqes_;
+
+    int fd_;
+    const std::vector<ReadUnit>& units_;
+    size_t depth_;
+    std::vector<std::vector<char>> buffers_;
+    std::vector<iovec> iovecs_;
+    std::vector<size_t> inFlight_;
+    std::vector<size_t> loaded_;
+    std::vector<std::exception_ptr> errors_; // Per slot, for the unit loaded_ there
+    size_t nextSubmit_;
+    size_t pending_;
+
+    void submit(size_t unit) {
+        size_t slot = unit % depth_;
+        buffers_[slot].resize(units_[unit].bytes_);
+        iovecs_[slot] = iovec { buffers_[slot].data(), buffers_[slot].size() };
+
+        unsigned tail = *sqTail_;
+        unsigned index = tail & *sqMask_;
+        io_uring_sqe& sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READV;
+        sqe.fd = fd_;
+        sqe.addr = reinterpret_cast<uint64_t>(&iovecs_[slot]);
+        sqe.len = 1;
+        sqe.off = units_[unit].offset_;
+        sqe.user_data = slot;
+        sqArray_[index] = index;
+        __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+
+        inFlight_[slot] = unit;
+        loaded_[slot] = SIZE_MAX;
+        errors_[slot] = nullptr;
+        pending_++;
+        if (::syscall(__NR_io_uring_enter, ring_, 1, 0, 0, nullptr, 0) < 0) {
+            pending_--;
+            throw std::runtime_error("io_uring_enter failed.");
+        }
+    }
+
+    void reap() {
+        while (true) {
+            unsigned head = *cqHead_;
+            if (head != __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE)) {
+                io_uring_cqe cqe = cqes_[head & *cqMask_];
+                __atomic_store_n(cqHead_, head + 1, __ATOMIC_RELEASE);
+                pending_--;
+
+                // A failure is kept with its unit, so earlier units are still handed out first
+                size_t slot = static_cast<size_t>(cqe.user_data);
+                const ReadUnit& unit = units_[inFlight_[slot]];
+                try {
+                    if (cqe.res < 0) {
+                        throw std::runtime_error(std::string("io_uring read failed: ") + std::strerror(-cqe.res));
+                    }
+                    // Finish any short read synchronously; they are rare for regular files
+                    size_t got = static_cast<size_t>(cqe.res);
+                    if (got < unit.bytes_) {
+                        readFully(fd_, buffers_[slot].data() + got, unit.bytes_ - got, unit.offset_ + got);
+                    }
+                } catch (const std::runtime_error&) {
+                    errors_[slot] = std::current_exception();
+                }
+                loaded_[slot] = inFlight_[slot];
+                return;
+            }
+            if (::syscall(__NR_io_uring_enter, ring_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR) {
+                throw std::runtime_error("io_uring_enter failed.");
+            }
+        }
+    }
+
+    void shutdown() {
+        // The kernel may still write into our buffers, so drain before freeing them
+        try {
+            while (pending_ > 0) {
+                reap();
+            }
+        } catch (...) {
+        }
+        release();
+    }
+
+    void release() {
+        if (sqes_ != nullptr) {
+            ::munmap(sqes_, sqesBytes_);
+        }
+        if (cqRing_ != nullptr && cqRing_ != sqRing_) {
+            ::munmap(cqRing_, cqRingBytes_);
+        }
+        if (sqRing_ != nullptr) {
+            ::munmap(sqRing_, sqRingBytes_);
+        }
+        ::close(ring_);
+    }
+
+public:
+    /**
+     * @throws std::runtime_error if io_uring is unavailable or not permitted.
+     */
+    UringPrefetcher(int fd, const std::vector<ReadUnit>& units, size_t depth)
+        : sqRing_ { nullptr }
+        , cqRing_ { nullptr }
+        , sqes_ { nullptr }
+        , fd_ { fd }
+        , units_ { units }
+        , depth_ { depth }
+        , buffers_(depth)
+        , iovecs_(depth)
+        , inFlight_(depth, SIZE_MAX)
+        , loaded_(depth, SIZE_MAX)
+        , errors_(depth)
+        , nextSubmit_ { 0 }
+        , pending_ { 0 }
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring_ = static_cast<int>(::syscall(__NR_io_uring_setup, static_cast<unsigned>(depth), &params));
+        if (ring_ < 0) {
+            throw std::runtime_error("io_uring is unavailable.");
+        }
+
+        sqRingBytes_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingBytes_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            sqRingBytes_ = cqRingBytes_ = std::max(sqRingBytes_, cqRingBytes_);
+        }
+        sqesBytes_ = params.sq_entries * sizeof(io_uring_sqe);
+
+        void* sqRing = ::mmap(nullptr, sqRingBytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_, IORING_OFF_SQ_RING);
+        void* cqRing = sqRing;
+        if (!(params.features & IORING_FEAT_SINGLE_MMAP) && sqRing != MAP_FAILED) {
+            cqRing = ::mmap(nullptr, cqRingBytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_, IORING_OFF_CQ_RING);
+        }
+        void* sqes = ::mmap(nullptr, sqesBytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_, IORING_OFF_SQES);
+        sqRing_ = sqRing == MAP_FAILED ? nullptr : sqRing;
+        cqRing_ = cqRing == MAP_FAILED ? nullptr : cqRing;
+        sqes_ = sqes == MAP_FAILED ? nullptr : static_cast<io_uring_sqe*>(sqes);
+        if (sqRing_ == nullptr || cqRing_ == nullptr || sqes_ == nullptr) {
+            release();
+            throw std::runtime_error("Unable to map io_uring queues.");
+        }
+
+        char* sq = static_cast<char*>(sqRing_);
+        char* cq = static_cast<char*>(cqRing_);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        try {
+            while (nextSubmit_ < std::min(depth_, units_.size())) {
+                submit(nextSubmit_);
+                nextSubmit_++;
+            }
+        } catch (...) {
+            shutdown();
+            throw;
+        }
+    }
+
+    ~UringPrefetcher() override {
+        shutdown();
+    }
+
+    const std::vector<char>& acquire(size_t index) override {
+        size_t slot = index % depth_;
+        // Refill the slot unit index - 1 released, once even if acquire() is retried
+        if (index > 0 && nextSubmit_ == index - 1 + depth_ && nextSubmit_ < units_.size()) {
+            submit(nextSubmit_);
+            nextSubmit_++;
+        }
+        while (loaded_[slot] != index) {
+            reap();
+        }
+        if (errors_[slot]) {
+            std::rethrow_exception(errors_[slot]);
+        }
+        return buffers_[slot];
+    }
+
+    bool usingIoUring() const override {
+        return true;
+    }
+};
+#endif
+}
+
+/**
+ * @brief Opens the archive at <path> & starts prefetching its first reads.
+ *
+ * @param path The packed archive to replay
+ * @param depth The number of reads kept in flight
+ * @param readSize The target size of each read, in bytes
+ * @param useIoUring Whether to try io_uring before falling back to a thread
+ * @throws std::runtime_error if the file cannot be read or is not a valid archive.
+ */
+PrefetchPlayerStream::PrefetchPlayerStream(const std::string& path, size_t depth, size_t readSize, bool useIoUring)
+    : fd_ { ::open(path.c_str(), O_RDONLY) }
+    , buffer_ { nullptr }
+    , nextUnit_ { 0 }
+    , nextBlock_ { 0 }
+{
+    if (fd_ < 0) {
+        throw std::runtime_error("Unable to open " + path + ".");
+    }
+    try {
+        struct stat info;
+        if (::fstat(fd_, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(PackedFileHeader)) {
+            throw std::runtime_error(path + " is not a valid packed player file.");
+        }
+        uint64_t fileBytes = static_cast<uint64_t>(info.st_size);
+
+        char header[sizeof(PackedFileHeader)];
+        readFully(fd_, header, sizeof(header), 0);
+        header_ = Packed::readHeader(header, header + sizeof(header));
+        if (header_.indexOffset_ > fileBytes) {
+            throw std::runtime_error(path + " is not a valid packed player file.");
+        }
+
+        directory_.resize(fileBytes - header_.dictionaryOffset_);
+        readFully(fd_, directory_.data(), directory_.size(), header_.dictionaryOffset_);
+        Packed::readDirectory(header_, directory_.data(), directory_.data() + directory_.size(), names_, blockOffsets_);
+
+        // Group consecutive blocks into reads of at least <readSize> bytes
+        for (size_t block = 0; block < blockOffsets_.size();) {
+            ReadUnit unit { blockOffsets_[block], 0, block, 0 };
+            while (block < blockOffsets_.size() && (unit.blocks_ == 0 || unit.bytes_ < readSize)) {
+                uint64_t blockEnd = block + 1 < blockOffsets_.size() ? blockOffsets_[block + 1] : header_.dictionaryOffset_;
+                if (blockEnd < blockOffsets_[block]) {
+                    throw std::runtime_error(path + " is not a valid packed player file.");
+                }
+                unit.bytes_ = blockEnd - unit.offset_;
+                unit.blocks_++;
+                block++;
+            }
+            units_.push_back(unit);
+        }
+
+        depth = std::max<size_t>(1, depth);
+#ifdef __linux__
+        if (useIoUring) {
+            try {
+                prefetcher_ = std::make_unique<UringPrefetcher>(fd_, units_, depth);
+            } catch (const std::runtime_error&) {
+                prefetcher_ = nullptr;
+            }
+        }
+#endif
+        if (!prefetcher_) {
+            prefetcher_ = std::make_unique<ThreadPrefetcher>(fd_, units_, depth);
+        }
+    } catch (...) {
+        ::close(fd_);
+        throw;
+    }
+    remaining_ = header_.count_;
+}
+
+PrefetchPlayerStream::~PrefetchPlayerStream() {
+    prefetcher_.reset();
+    ::close(fd_);
+}
+
+/**
+ * @brief Decodes the next block, first waiting for the read holding it.
+ */
+void PrefetchPlayerStream::nextBlock() {
+    if (buffer_ == nullptr || nextBlock_ == units_[nextUnit_ - 1].firstBlock_ + units_[nextUnit_ - 1].blocks_) {
+        if (nextUnit_ >= units_.size()) {
+            throw std::runtime_error("Corrupt packed player file.");
+        }
+        buffer_ = &prefetcher_->acquire(nextUnit_);
+        nextUnit_++; // Only once acquired, so a failed read is thrown again on retry
+    }
+    const ReadUnit& unit = units_[nextUnit_ - 1];
+    uint64_t blockEnd = nextBlock_ + 1 < blockOffsets_.size() ? blockOffsets_[nextBlock_ + 1] : header_.dictionaryOffset_;
+    const char* begin = buffer_->data() + (blockOffsets_[nextBlock_] - unit.offset_);
+    const char* end = buffer_->data() + (blockEnd - unit.offset_);
+
+    Packed::decodeBlock(begin, end, header_.blockSize_, names_.size(), block_);
+    nextBlock_++;
+}
+
+/**
+ * @brief Returns whether reads are being issued through io_uring.
+ */
+bool PrefetchPlayerStream::usingIoUring() const {
+    return prefetcher_->usingIoUring();
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "PackedPlayerFile.hpp"
+#include "Player.hpp"
+#include "PlayerStream.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A PlayerStream replaying a packed archive (see writePackedPlayerFile())
+ * with its reads issued ahead of the consumer.
+ *
+ * The archive's blocks are grouped into reads of roughly <readSize> bytes, &
+ * up to <depth> of them are kept in flight. While the consumer decodes one
+ * completed read, the following ones load. Reads go through Linux io_uring
+ * when the kernel allows it, & otherwise through a background thread
+ * issuing pread()s, so ranking never stalls on a synchronous refill.
+ */
+class PrefetchPlayerStream final : public Packed::BlockStream {
+public:
+    /**
+     * @brief Loads buffers of the archive, in order, ahead of their use.
+     */
+    class Prefetcher;
+
+    /**
+     * @brief A contiguous run of whole blocks, fetched with a single read.
+     */
+    struct ReadUnit {
+        uint64_t offset_;
+        uint64_t bytes_;
+        size_t firstBlock_;
+        size_t blocks_;
+    };
+
+private:
+    int fd_;
+    PackedFileHeader header_;
+    std::vector<char> directory_; // Backs names_
+    std::vector<uint64_t> blockOffsets_;
+    std::vector<ReadUnit> units_;
+    std::unique_ptr<Prefetcher> prefetcher_;
+
+    const std::vector<char>* buffer_;
+    size_t nextUnit_;
+    size_t nextBlock_;
+
+    void nextBlock() override;
+
+public:
+    /**
+     * @brief Opens the archive at <path> & starts prefetching its first reads.
+     *
+     * @param path The packed archive to replay
+     * @param depth The number of reads kept in flight
+     * @param readSize The target size of each read, in bytes
+     * @param useIoUring Whether to try io_uring before falling back to a thread
+     * @throws std::runtime_error if the file cannot be read or is not a valid archive.
+     */
+    explicit PrefetchPlayerStream(const std::string& path, size_t depth = 4, size_t readSize = 1 << 20, bool useIoUring = true);
+    ~PrefetchPlayerStream();
+
+    PrefetchPlayerStream(const PrefetchPlayerStream&) = delete;
+    PrefetchPlayerStream& operator=(const PrefetchPlayerStream&) = delete;
+
+    /**
+     * @brief Returns whether reads are being issued through io_uring.
+     */
+    bool usingIoUring() const;
+};
@@ -0,0 +1,54 @@
+#include "RankingArena.hpp"
+#include "Player.hpp"
+
+#include <utility>
+
+/**
+ * @brief Allocates an arena of <bytes> bytes.
+ *
+ * @param upstream The resource serving requests once the buffer runs out
+ */
+RankingArena::RankingArena(size_t bytes, std::pmr::memory_resource* upstream)
+    : buffer_ { new std::byte[bytes] }
+    , capacity_ { bytes }
+    , resource_ { buffer_.get(), bytes, upstream }
+{
+}
+
+/**
+ * @brief Returns the resource to pass to the ranking engines.
+ */
+std::pmr::memory_resource* RankingArena::resource() {
+    return &resource_;
+}
+
+/**
+ * @brief Releases every allocation made from the arena.
+ */
+void RankingArena::release() {
+    resource_.release();
+}
+
+/**
+ * @brief Returns the size of the upfront buffer, in bytes.
+ */
+size_t RankingArena::capacity() const {
+    return capacity_;
+}
+
+/**
+ * @brief Returns a buffer size large enough for <rankings> results of
+ * <topCount> Players & <milestones> cutoffs each.
+ */
+size_t RankingArena::bytesFor(size_t rankings, size_t topCount, size_t milestones) {
+    // Each allocation may be padded up to the strictest alignment
+    constexpr size_t slack = alignof(std::max_align_t);
+
+    // A hash node holds a next pointer & the (level, count) pair; the bucket
+    // array is reserved to at least one pointer per milestone
+    constexpr size_t node = sizeof(void*) + sizeof(std::pair<const size_t, size_t>);
+    size_t cutoffs = milestones == 0 ? 0 : milestones * (node + 2 * sizeof(void*)) + 4 * slack;
+
+    size_t perRanking = topCount * sizeof(Player) + slack + cutoffs;
+    return rankings * perRanking;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+/**
+ * @brief A monotonic memory resource for batches of one-shot rankings.
+ *
+ * The arena allocates a single buffer on construction & hands it out
+ * linearly: deallocation is a no-op & release() reclaims everything at once.
+ * Size it with bytesFor() so a whole batch fits; should it run out, further
+ * requests fall back to the upstream resource rather than failing.
+ *
+ * @example Ranking a batch of guild boards
+ *   RankingArena arena(RankingArena::bytesFor(guilds.size(), 100, 1));
+ *   for (auto& guild : guilds) {
+ *       PmrRankingResult result = Offline::quickSelectRank(guild, arena.resource());
+ *       ...
+ *   }
+ *   arena.release(); // Every result above is gone
+ */
+class RankingArena {
+private:
+    std::unique_ptr<std::byte[]> buffer_;
+    size_t capacity_;
+    std::pmr::monotonic_buffer_resource resource_;
+
+public:
+    /**
+     * @brief Allocates an arena of <bytes> bytes.
+     *
+     * @param upstream The resource serving requests once the buffer runs out
+     */
+    explicit RankingArena(size_t bytes, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+    RankingArena(const RankingArena&) = delete;
+    RankingArena& operator=(const RankingArena&) = delete;
+
+    /**
+     * @brief Returns the resource to pass to the ranking engines.
+     */
+    std::pmr::memory_resource* resource();
+
+    /**
+     * @brief Releases every allocation made from the arena, invalidating all
+     * results allocated from it.
+     */
+    void release();
+
+    /**
+     * @brief Returns the size of the upfront buffer, in bytes.
+     */
+    size_t capacity() const;
+
+    /**
+     * @brief Returns a buffer size large enough for <rankings> results of
+     * <topCount> Players & <milestones> cutoffs each.
+     *
+     * Offline results have no cutoffs; rankIncoming() records
+     * ceil(N / reporting_interval) of them.
+     */
+    static size_t bytesFor(size_t rankings, size_t topCount, size_t milestones = 0);
+};
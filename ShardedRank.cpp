@@ -0,0 +1,382 @@
+#include "ShardedRank.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+// Requests from the coordinator
+const uint64_t OP_ROUND = 1;
+const uint64_t OP_SHIP = 2;
+
+const size_t RECEIVE_CHUNK = 1 << 16;
+
+// Fences each shard sends per round, relative to the number of shards
+const size_t FENCES_PER_SHARD = 4;
+const size_t STRIDE_SHRINK = 16;
+
+/**
+ * @brief A buffered, byte-counting connection to the other side of the protocol.
+ *
+ * Writes accumulate until flush(); reads are served from a receive buffer.
+ */
+class Channel {
+    int fd_;
+    std::vector<char> out_;
+    std::vector<char> in_;
+    size_t inPos_;
+    size_t bytes_;
+
+    void fill() {
+        in_.resize(RECEIVE_CHUNK);
+        while (true) {
+            ssize_t received = ::recv(fd_, in_.data(), in_.size(), 0);
+            if (received > 0) {
+                in_.resize(static_cast<size_t>(received));
+                inPos_ = 0;
+                bytes_ += static_cast<size_t>(received);
+                return;
+            }
+            if (received == 0) {
+                throw std::runtime_error("Shard connection closed unexpectedly.");
+            }
+            if (errno != EINTR) {
+                throw std::runtime_error(std::string("Shard connection failed: ") + std::strerror(errno));
+            }
+        }
+    }
+
+public:
+    explicit Channel(int fd)
+        : fd_ { fd }
+        , inPos_ { 0 }
+        , bytes_ { 0 }
+    {}
+
+    void put(const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        out_.insert(out_.end(), bytes, bytes + size);
+    }
+
+    void putWord(uint64_t word) {
+        put(&word, sizeof(word));
+    }
+
+    void flush() {
+        size_t sent = 0;
+        while (sent < out_.size()) {
+            ssize_t written = ::send(fd_, out_.data() + sent, out_.size() - sent, MSG_NOSIGNAL);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("Shard connection failed: ") + std::strerror(errno));
+            }
+            sent += static_cast<size_t>(written);
+        }
+        bytes_ += sent;
+        out_.clear();
+    }
+
+    void get(void* data, size_t size) {
+        char* bytes = static_cast<char*>(data);
+        while (size > 0) {
+            if (inPos_ == in_.size()) {
+                fill();
+            }
+            size_t count = std::min(size, in_.size() - inPos_);
+            std::memcpy(bytes, in_.data() + inPos_, count);
+            inPos_ += count;
+            bytes += count;
+            size -= count;
+        }
+    }
+
+    uint64_t getWord() {
+        uint64_t word;
+        get(&word, sizeof(word));
+        return word;
+    }
+
+    /**
+     * @brief Returns the bytes sent & received so far.
+     */
+    size_t bytes() const { return bytes_; }
+};
+
+/**
+ * @brief The bytes a Player takes on the wire: level, id, name length & name.
+ */
+size_t wireBytes(const Player& player) {
+    return 3 * sizeof(uint64_t) + player.name_.size();
+}
+
+/**
+ * @brief The forked shard processes & the coordinator's end of their sockets.
+ * Closing the sockets ends any shard still waiting on the coordinator.
+ */
+struct ShardProcesses {
+    std::vector<int> fds_;
+    std::vector<pid_t> pids_;
+
+    /**
+     * @brief Closes every socket & reaps every shard process.
+     * @return Whether every shard process exited successfully
+     */
+    bool join() {
+        for (int fd : fds_) {
+            ::close(fd);
+        }
+        fds_.clear();
+        bool succeeded = true;
+        for (pid_t pid : pids_) {
+            int status = 0;
+            while (::waitpid(pid, &status, 0) < 0 && errno == EINTR) { }
+            succeeded = succeeded && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        }
+        pids_.clear();
+        return succeeded;
+    }
+
+    ~ShardProcesses() {
+        join();
+    }
+};
+}
+
+/**
+ * @brief Serves one shard's side of the protocol over <fd> until its
+ *        candidates have been shipped.
+ */
+void Sharded::serveShard(int fd, std::vector<Player> players) {
+    Channel channel(fd);
+
+    size_t gatherBytes = sizeof(uint64_t);
+    for (const Player& player : players) {
+        gatherBytes += wireBytes(player);
+    }
+    channel.putWord(players.size());
+    channel.putWord(gatherBytes);
+    channel.flush();
+
+    // No Player outside the local top topCount can be in the global top topCount
+    size_t topCount = channel.getWord();
+    size_t keep = std::min(topCount, players.size());
+    std::nth_element(players.begin(), players.begin() + keep, players.end(), std::greater<Player>());
+    players.resize(keep);
+    std::sort(players.begin(), players.end(), std::greater<Player>());
+
+    auto atOrAbove = [&](uint64_t threshold) {
+        return static_cast<size_t>(std::partition_point(players.begin(), players.end(), [&](const Player& player) {
+            return player.level_ >= threshold;
+        }) - players.begin());
+    };
+    auto above = [&](uint64_t threshold) {
+        return static_cast<size_t>(std::partition_point(players.begin(), players.end(), [&](const Player& player) {
+            return player.level_ > threshold;
+        }) - players.begin());
+    };
+
+    while (true) {
+        uint64_t op = channel.getWord();
+        uint64_t threshold = channel.getWord();
+
+        if (op == OP_ROUND) {
+            size_t stride = std::max<uint64_t>(1, channel.getWord());
+            size_t candidates = atOrAbove(threshold);
+            channel.putWord(candidates);
+            channel.putWord(above(threshold));
+
+            // Fence j certifies j * stride Players at or above its level
+            channel.putWord(candidates / stride);
+            for (size_t j = 1; j * stride <= candidates; ++j) {
+                channel.putWord(players[j * stride - 1].level_);
+            }
+            channel.flush();
+        } else if (op == OP_SHIP) {
+            uint64_t quota = channel.getWord();
+            size_t strictlyAbove = above(threshold);
+            size_t shipped = strictlyAbove + std::min<uint64_t>(quota, atOrAbove(threshold) - strictlyAbove);
+
+            channel.putWord(shipped);
+            for (size_t i = 0; i < shipped; ++i) {
+                const Player& player = players[i];
+                channel.putWord(player.level_);
+                channel.putWord(player.id_);
+                channel.putWord(player.name_.size());
+                channel.put(player.name_.data(), player.name_.size());
+            }
+            channel.flush();
+            return;
+        } else {
+            throw std::runtime_error("Unknown shard request.");
+        }
+    }
+}
+
+/**
+ * @brief Coordinates the shards connected on <fds> & ranks their Players.
+ */
+ShardedRankingResult Sharded::coordinate(const std::vector<int>& fds) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    ShardedRankingResult result;
+    result.shards_ = fds.size();
+    std::vector<Channel> channels(fds.begin(), fds.end());
+
+    size_t totalPlayers = 0;
+    for (Channel& channel : channels) {
+        totalPlayers += channel.getWord();
+        result.bytesGathered_ += channel.getWord();
+    }
+    size_t topCount = (totalPlayers + 9) / 10; // Ceiling of 10%
+    for (Channel& channel : channels) {
+        channel.putWord(topCount);
+        channel.flush();
+    }
+
+    // Invariant: at least topCount Players are at or above the threshold
+    size_t shardCount = std::max<size_t>(1, channels.size());
+    uint64_t threshold = 0;
+    size_t stride = std::max<size_t>(1, topCount / (FENCES_PER_SHARD * shardCount));
+    size_t slack = std::max(shardCount, topCount / 64);
+    std::vector<size_t> atOrAbove(channels.size());
+    std::vector<size_t> above(channels.size());
+    size_t totalAbove = 0;
+    bool exact = false;
+
+    while (topCount > 0) {
+        result.rounds_++;
+        for (Channel& channel : channels) {
+            channel.putWord(OP_ROUND);
+            channel.putWord(threshold);
+            channel.putWord(stride);
+            channel.flush();
+        }
+
+        std::vector<uint64_t> fences;
+        size_t totalAtOrAbove = 0;
+        totalAbove = 0;
+        for (size_t i = 0; i < channels.size(); ++i) {
+            atOrAbove[i] = channels[i].getWord();
+            above[i] = channels[i].getWord();
+            totalAtOrAbove += atOrAbove[i];
+            totalAbove += above[i];
+            for (size_t count = channels[i].getWord(); count > 0; --count) {
+                fences.push_back(channels[i].getWord());
+            }
+        }
+
+        // Fewer than topCount Players above the threshold makes it the cutoff
+        exact = totalAbove < topCount;
+        if (exact || totalAtOrAbove <= topCount + slack) {
+            break;
+        }
+
+        // At stride 1 the fences are every candidate, so this reaches the cutoff
+        size_t needed = (topCount + stride - 1) / stride;
+        if (fences.size() >= needed) {
+            std::nth_element(fences.begin(), fences.begin() + (needed - 1), fences.end(), std::greater<uint64_t>());
+            threshold = std::max(threshold, fences[needed - 1]);
+        }
+        stride = std::max<size_t>(1, stride / STRIDE_SHRINK);
+    }
+
+    // Ship the Players above the threshold, & at an exact cutoff only the ties needed
+    size_t tiesNeeded = topCount > totalAbove ? topCount - totalAbove : 0;
+    for (size_t i = 0; i < channels.size(); ++i) {
+        uint64_t quota = UINT64_MAX;
+        if (topCount == 0) {
+            threshold = UINT64_MAX;
+            quota = 0;
+        } else if (exact) {
+            quota = std::min(tiesNeeded, atOrAbove[i] - above[i]);
+            tiesNeeded -= quota;
+        }
+        channels[i].putWord(OP_SHIP);
+        channels[i].putWord(threshold);
+        channels[i].putWord(quota);
+        channels[i].flush();
+    }
+
+    std::vector<Player> topPlayers;
+    topPlayers.reserve(topCount);
+    for (Channel& channel : channels) {
+        for (size_t count = channel.getWord(); count > 0; --count) {
+            Player player;
+            player.level_ = channel.getWord();
+            player.id_ = channel.getWord();
+            player.name_.resize(channel.getWord());
+            channel.get(&player.name_[0], player.name_.size());
+            topPlayers.push_back(std::move(player));
+        }
+    }
+    result.candidates_ = topPlayers.size();
+
+    // Short of an exact cutoff, a few surplus Players were shipped
+    if (topPlayers.size() > topCount) {
+        std::nth_element(topPlayers.begin(), topPlayers.end() - topCount, topPlayers.end());
+        topPlayers.erase(topPlayers.begin(), topPlayers.end() - topCount);
+    }
+    std::sort(topPlayers.begin(), topPlayers.end());
+
+    for (const Channel& channel : channels) {
+        result.bytesMoved_ += channel.bytes();
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+    result.ranking_ = RankingResult(std::move(topPlayers), {}, elapsed);
+    return result;
+}
+
+/**
+ * @brief Ranks the top 10% of the union of <shards>, serving each shard from
+ *        its own forked process & coordinating from this one.
+ */
+ShardedRankingResult Offline::shardedRank(const std::vector<std::vector<Player>>& shards) {
+    ShardProcesses processes;
+
+    for (const std::vector<Player>& shard : shards) {
+        int pair[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+            throw std::runtime_error(std::string("Unable to create shard socket: ") + std::strerror(errno));
+        }
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            ::close(pair[0]);
+            ::close(pair[1]);
+            throw std::runtime_error(std::string("Unable to fork shard process: ") + std::strerror(errno));
+        }
+        if (pid == 0) {
+            // The shard process only keeps its own end of its own socket
+            ::close(pair[0]);
+            for (int fd : processes.fds_) {
+                ::close(fd);
+            }
+            int status = 0;
+            try {
+                Sharded::serveShard(pair[1], shard);
+            } catch (...) {
+                status = 1;
+            }
+            ::_exit(status);
+        }
+        ::close(pair[1]);
+        processes.fds_.push_back(pair[0]);
+        processes.pids_.push_back(pid);
+    }
+
+    ShardedRankingResult result = Sharded::coordinate(processes.fds_);
+    if (!processes.join()) {
+        throw std::runtime_error("A shard process failed.");
+    }
+    return result;
+}
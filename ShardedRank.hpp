@@ -0,0 +1,81 @@
+#pragma once
+#include "Leaderboard.hpp"
+#include "Player.hpp"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief The outcome of ranking Players spread across shard processes.
+ *
+ * - ranking_       -> The global ranking, identical to Offline::quickSelectRank()
+ *                     on the union of the shards. elapsed_ covers every round.
+ * - shards_        -> The number of shards ranked
+ * - rounds_        -> The number of threshold rounds before shipping
+ * - candidates_    -> The number of Players shipped to the coordinator
+ * - bytesMoved_    -> Bytes exchanged with the shards, in both directions
+ * - bytesGathered_ -> Bytes that shipping every Player would have taken
+ */
+struct ShardedRankingResult {
+    RankingResult ranking_;
+    size_t shards_ = 0;
+    size_t rounds_ = 0;
+    size_t candidates_ = 0;
+    size_t bytesMoved_ = 0;
+    size_t bytesGathered_ = 0;
+};
+
+/**
+ * @brief A coordinator/shard protocol for ranking the top 10% of Players
+ * owned by separate processes, over connected stream sockets (eg. from
+ * socketpair() or a Unix domain socket).
+ *
+ * 1) Each shard reports its size; the coordinator replies with the global
+ *    topCount, ceil(N / 10), & each shard keeps only its local top topCount.
+ * 2) In each round (TPUT-style) the coordinator broadcasts a threshold & a
+ *    stride. Each shard replies with its number of Players at or above &
+ *    strictly above the threshold, plus "fences": every stride-th level of
+ *    its Players at or above it. Fence j certifies j * stride Players, so the
+ *    ceil(topCount / stride)-th highest fence is a safe new threshold. The
+ *    stride shrinks each round.
+ * 3) Rounds stop once the threshold is the exact cutoff, or few enough
+ *    Players are at or above it. Only the Players above the threshold are
+ *    then shipped, plus, at an exact cutoff, just the share of tied Players
+ *    each shard is assigned, so exactly topCount Players are shipped.
+ */
+namespace Sharded {
+/**
+ * @brief Serves one shard's side of the protocol over <fd> until its
+ *        candidates have been shipped.
+ *
+ * @param fd A connected stream socket to the coordinator
+ * @param players The Players owned by the shard
+ *
+ * @throws std::runtime_error if the coordinator hangs up or the socket fails.
+ */
+void serveShard(int fd, std::vector<Player> players);
+
+/**
+ * @brief Coordinates the shards connected on <fds> & ranks their Players.
+ *
+ * @param fds A connected stream socket to each shard
+ * @return A ShardedRankingResult holding the global ranking & the traffic used
+ *
+ * @throws std::runtime_error if a shard hangs up or a socket fails.
+ */
+ShardedRankingResult coordinate(const std::vector<int>& fds);
+}
+
+namespace Offline {
+/**
+ * @brief Ranks the top 10% of the union of <shards>, serving each shard from
+ *        its own forked process & coordinating from this one.
+ *
+ * @param shards The Players owned by each shard
+ * @return A ShardedRankingResult holding the global ranking & the traffic used
+ *
+ * @throws std::runtime_error if a process or socket cannot be created, or a
+ *      shard process fails.
+ */
+ShardedRankingResult shardedRank(const std::vector<std::vector<Player>>& shards);
+}
@@ -0,0 +1,161 @@
+#include "SmallTopK.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define SMALL_HAVE_AVX2 1
+#endif
+
+namespace {
+constexpr uint64_t SIGN = 1ULL << 63;
+
+int64_t biased(uint64_t level) {
+    return static_cast<int64_t>(level ^ SIGN);
+}
+
+/**
+ * @brief Returns the number of entries of <levels> strictly below <key>,
+ * scanning <vectors> groups of 4.
+ */
+size_t countBelowScalar(const int64_t* levels, size_t vectors, int64_t key) {
+    size_t count = 0;
+    for (size_t i = 0; i < vectors * 4; ++i) {
+        count += levels[i] < key;
+    }
+    return count;
+}
+
+/**
+ * @brief Moves entries [1, rank) of <values> down to [0, rank - 1).
+ */
+void shiftDownScalar(int64_t* values, size_t rank) {
+    for (size_t i = 0; i + 1 < rank; ++i) {
+        values[i] = values[i + 1];
+    }
+}
+
+#ifdef SMALL_HAVE_AVX2
+__attribute__((target("avx2,popcnt"))) size_t countBelowAvx2(const int64_t* levels, size_t vectors, int64_t key) {
+    const __m256i keys = _mm256_set1_epi64x(key);
+    size_t count = 0;
+    for (size_t v = 0; v < vectors; ++v) {
+        __m256i below = _mm256_cmpgt_epi64(keys, _mm256_load_si256(reinterpret_cast<const __m256i*>(levels + 4 * v)));
+        count += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(below)));
+    }
+    return count;
+}
+
+/**
+ * @brief An AVX2 shiftDownScalar(). Each step loads 4 entries before any of
+ * them is overwritten, so the overlapping forward copy is safe; the final
+ * partial vector is written with a masked store so entries at or past
+ * <rank> are left alone.
+ */
+__attribute__((target("avx2"))) void shiftDownAvx2(int64_t* values, size_t rank) {
+    size_t moved = rank - 1;
+    size_t i = 0;
+    for (; i + 4 <= moved; i += 4) {
+        __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i + 1));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i), next);
+    }
+    size_t tail = moved - i;
+    if (tail > 0) {
+        const __m256i lanes = _mm256_set_epi64x(3, 2, 1, 0);
+        __m256i mask = _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<long long>(tail)), lanes);
+        __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i + 1));
+        _mm256_maskstore_epi64(reinterpret_cast<long long*>(values + i), mask, next);
+    }
+}
+#endif
+}
+
+/**
+ * @brief Returns whether this build & CPU can run the AVX2 kernels.
+ */
+bool SmallTopK::hasAvx2() {
+#ifdef SMALL_HAVE_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Constructs an empty board of <capacity> levels.
+ *
+ * @throws std::invalid_argument if <capacity> is 0 or exceeds MAX_K, or
+ *      <kernel> is Kernel::Avx2 & hasAvx2() is false.
+ */
+SmallTopK::SmallTopK(size_t capacity, Kernel kernel)
+    : capacity_ { capacity }
+    , size_ { 0 }
+    , cutoff_ { 0 }
+    , avx2_ { kernel != Kernel::Scalar && hasAvx2() }
+{
+    if (capacity == 0 || capacity > MAX_K) {
+        throw std::invalid_argument("SmallTopK capacity must be between 1 and 64.");
+    }
+    if (kernel == Kernel::Avx2 && !avx2_) {
+        throw std::invalid_argument("SmallTopK AVX2 kernels are not supported here.");
+    }
+    for (size_t i = 0; i < MAX_K + 4; ++i) {
+        levels_[i] = INT64_MAX;
+        slots_[i] = 0;
+    }
+}
+
+/**
+ * @brief Inserts a level while the board is filling; its slot is the next free one.
+ */
+size_t SmallTopK::insertFilling(uint64_t level) {
+    int64_t key = biased(level);
+    size_t rank = size_;
+    while (rank > 0 && levels_[rank - 1] > key) {
+        levels_[rank] = levels_[rank - 1];
+        slots_[rank] = slots_[rank - 1];
+        rank--;
+    }
+    levels_[rank] = key;
+    slots_[rank] = static_cast<int64_t>(size_);
+    cutoff_ = static_cast<uint64_t>(levels_[0]) ^ SIGN;
+    return size_++;
+}
+
+/**
+ * @brief Replaces the minimum of a full board with <level>.
+ * @pre level > cutoff()
+ */
+size_t SmallTopK::insertFull(uint64_t level) {
+    int64_t key = biased(level);
+    size_t vectors = (capacity_ + 3) / 4;
+    size_t slot = static_cast<size_t>(slots_[0]);
+
+    // levels_[0] < key, so rank >= 1
+    size_t rank;
+#ifdef SMALL_HAVE_AVX2
+    if (avx2_) {
+        rank = countBelowAvx2(levels_, vectors, key);
+        shiftDownAvx2(levels_, rank);
+        shiftDownAvx2(slots_, rank);
+    } else
+#endif
+    {
+        rank = countBelowScalar(levels_, vectors, key);
+        shiftDownScalar(levels_, rank);
+        shiftDownScalar(slots_, rank);
+    }
+    levels_[rank - 1] = key;
+    slots_[rank - 1] = static_cast<int64_t>(slot);
+    cutoff_ = static_cast<uint64_t>(levels_[0]) ^ SIGN;
+    return slot;
+}
+
+/**
+ * @brief Returns the <i>-th lowest level.
+ */
+uint64_t SmallTopK::level(size_t i) const {
+    return static_cast<uint64_t>(levels_[i]) ^ SIGN;
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief A top-k tracker for small boards (k <= 64) that keeps the levels in
+ * a sorted, vector-register-sized array & leaves the payload to the caller.
+ *
+ * push() hands back a slot in [0, k) for the caller to store the accepted
+ * Player (or row, or pointer) in, so the payload lives in a parallel array
+ * the caller owns, eg. the heap vector of Online::rankIncoming(). Once the
+ * board is full, an accepted level is ranked with a handful of vector
+ * compares (4 levels per AVX2 compare, counted via movemask & popcount)
+ * & the levels below it are shifted down with unaligned vector moves &
+ * a masked store for the tail. CPUs without AVX2 use a scalar fallback,
+ * chosen at runtime (or forced through Kernel, eg. to test both).
+ *
+ * Acceptance matches Online::replaceMin(): once full, a level enters only if
+ * it is strictly greater than cutoff(), & evicts the minimum.
+ *
+ * @example
+ *   SmallTopK board(10);
+ *   std::vector<Player> slots(10);
+ *   for (Player& player : players) {
+ *       size_t slot = board.push(player.level_);
+ *       if (slot != SmallTopK::REJECTED) slots[slot] = std::move(player);
+ *   }
+ */
+class SmallTopK {
+public:
+    static constexpr size_t MAX_K = 64;
+    static constexpr size_t REJECTED = ~static_cast<size_t>(0);
+
+    /**
+     * @brief The kernels ranking & shifting levels once the board is full.
+     * - Best   -> AVX2 where the CPU supports it, otherwise scalar
+     * - Scalar -> the portable loops
+     * - Avx2   -> the vector kernels; see hasAvx2()
+     */
+    enum class Kernel { Best, Scalar, Avx2 };
+
+private:
+    // Levels are stored with their sign bit flipped so that the signed 64-bit
+    // compares of AVX2 order them as unsigned. Entries past size_ (plus one
+    // vector of padding) hold INT64_MAX so they never rank below a level.
+    alignas(32) int64_t levels_[MAX_K + 4];
+    alignas(32) int64_t slots_[MAX_K + 4];
+    size_t capacity_;
+    size_t size_;
+    uint64_t cutoff_;
+    bool avx2_;
+
+    size_t insertFull(uint64_t level);
+    size_t insertFilling(uint64_t level);
+
+public:
+    /**
+     * @brief Constructs an empty board of <capacity> levels.
+     *
+     * @throws std::invalid_argument if <capacity> is 0 or exceeds MAX_K, or
+     *      <kernel> is Kernel::Avx2 & hasAvx2() is false.
+     */
+    explicit SmallTopK(size_t capacity, Kernel kernel = Kernel::Best);
+
+    /**
+     * @brief Returns whether this build & CPU can run the AVX2 kernels.
+     */
+    static bool hasAvx2();
+
+    /**
+     * @brief Offers a level to the board.
+     *
+     * @return The slot the caller should store the accepted payload in
+     *      (the evicted payload's slot once the board is full), or REJECTED.
+     */
+    size_t push(uint64_t level) {
+        if (size_ == capacity_) {
+            return level > cutoff_ ? insertFull(level) : REJECTED;
+        }
+        return insertFilling(level);
+    }
+
+    /**
+     * @brief Returns the minimum level on the board.
+     * @pre size() > 0
+     */
+    uint64_t cutoff() const { return cutoff_; }
+
+    /**
+     * @brief Returns the number of levels held.
+     */
+    size_t size() const { return size_; }
+
+    /**
+     * @brief Returns the board's capacity, k.
+     */
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief Returns the slot holding the <i>-th lowest level.
+     * @pre i < size()
+     */
+    size_t slot(size_t i) const { return static_cast<size_t>(slots_[i]); }
+
+    /**
+     * @brief Returns the <i>-th lowest level.
+     * @pre i < size()
+     */
+    uint64_t level(size_t i) const;
+};
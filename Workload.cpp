@@ -0,0 +1,204 @@
+#include "Workload.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+const char* const NAMES[] = { "uniform", "zipf", "normal", "ascending", "descending", "few-distinct", "quickselect-killer" };
+
+uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Maps a 64-bit hash to [0, bound) without modulo bias worth noting.
+ */
+uint64_t below(uint64_t hash, uint64_t bound) {
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(hash) * bound) >> 64);
+}
+
+/**
+ * @brief Maps a 64-bit hash to a double in (0, 1].
+ */
+double unit(uint64_t hash) {
+    return static_cast<double>((hash >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief Returns element <index> of Musser's median-of-3 killer permutation
+ * of 1..count.
+ *
+ * Musser's construction is defined for count = 2k with k even:
+ * 1, k+1, 3, k+3, ..., k-1, 2k-1, then 2, 4, ..., 2k. Other counts take it
+ * over the largest multiple of 4 below count & append the (at most 3)
+ * remaining, largest values in ascending order, which keeps the first, middle
+ * & last median-of-3 pivot near the bottom of every partition.
+ */
+size_t killer(size_t count, size_t index) {
+    size_t musser = count / 4 * 4;
+    size_t half = musser / 2;
+    if (index >= musser) {
+        return index + 1;
+    }
+    if (index < half) {
+        return index % 2 == 0 ? index + 1 : half + index;
+    }
+    return 2 * (index - half + 1);
+}
+
+/**
+ * @brief Runs body(first, last) over <threads> slices of [0, count).
+ */
+template <typename Body>
+void parallelFor(size_t count, size_t threads, Body body) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::max<size_t>(1, std::min(threads, count / 65536));
+
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t) {
+        workers.emplace_back(body, count * t / threads, count * (t + 1) / threads);
+    }
+    body(0, count / threads);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Truncates a level drawn over [0, maxLevel] to a size_t, saturating
+ * at <maxLevel>; (double) SIZE_MAX rounds up to 2^64, which no cast can hold.
+ */
+size_t toLevel(double x, size_t maxLevel) {
+    return x >= static_cast<double>(maxLevel) ? maxLevel : static_cast<size_t>(x);
+}
+}
+
+/**
+ * @brief Returns the level of Player <index> of an <count>-Player workload.
+ */
+size_t workloadLevel(const WorkloadSpec& spec, size_t count, size_t index) {
+    uint64_t hash = splitmix64(spec.seed_ ^ splitmix64(index));
+    uint64_t range = static_cast<uint64_t>(spec.maxLevel_) + 1; // 0 when every uint64_t is a level
+
+    switch (spec.distribution_) {
+    case Distribution::Uniform:
+        return range == 0 ? hash : below(hash, range);
+    case Distribution::Zipf: {
+        // Inverse CDF of a continuous power law over [1, maxLevel_]
+        double top = static_cast<double>(std::max<size_t>(spec.maxLevel_, 1));
+        double u = unit(hash);
+        double x = spec.zipfSkew_ == 1.0
+            ? std::pow(top, u)
+            : std::pow((std::pow(top, 1 - spec.zipfSkew_) - 1) * u + 1, 1 / (1 - spec.zipfSkew_));
+        return toLevel(x, spec.maxLevel_);
+    }
+    case Distribution::Normal: {
+        // Box-Muller over two uniforms derived from the same hash
+        double radius = std::sqrt(-2 * std::log(unit(hash)));
+        double angle = 6.283185307179586 * unit(splitmix64(hash));
+        double x = spec.maxLevel_ / 2.0 + spec.maxLevel_ / 8.0 * radius * std::cos(angle);
+        return toLevel(std::max(x, 0.0), spec.maxLevel_);
+    }
+    case Distribution::Ascending:
+        return count <= 1 ? 0 : static_cast<size_t>(static_cast<unsigned __int128>(index) * spec.maxLevel_ / (count - 1));
+    case Distribution::Descending:
+        return count <= 1 ? spec.maxLevel_ : static_cast<size_t>(static_cast<unsigned __int128>(count - 1 - index) * spec.maxLevel_ / (count - 1));
+    case Distribution::FewDistinct: {
+        size_t distinct = std::max<size_t>(spec.distinct_, 1);
+        return below(hash, distinct) * (spec.maxLevel_ / distinct);
+    }
+    case Distribution::QuickselectKiller:
+        return killer(count, index);
+    }
+    return 0;
+}
+
+/**
+ * @brief Fills levels[0, count) with the levels of an <count>-Player workload.
+ *
+ * @param threads The number of threads to use; 0 uses every core
+ */
+void fillWorkloadLevels(const WorkloadSpec& spec, uint64_t* levels, size_t count, size_t threads) {
+    parallelFor(count, threads, [&spec, levels, count](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            levels[i] = workloadLevel(spec, count, i);
+        }
+    });
+}
+
+/**
+ * @brief Generates the Players of an <count>-Player workload.
+ *
+ * @param threads The number of threads to use; 0 uses every core
+ */
+std::vector<Player> generateWorkload(const WorkloadSpec& spec, size_t count, size_t threads) {
+    std::vector<Player> players(count);
+    parallelFor(count, threads, [&spec, &players, count](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            players[i].name_ = "p" + std::to_string(i);
+            players[i].level_ = workloadLevel(spec, count, i);
+            players[i].id_ = i;
+        }
+    });
+    return players;
+}
+
+/**
+ * @brief Parses a distribution name, as printed by distributionName().
+ *
+ * @throws std::invalid_argument if <name> names no distribution.
+ */
+Distribution parseDistribution(const std::string& name) {
+    for (size_t i = 0; i < std::size(NAMES); ++i) {
+        if (name == NAMES[i]) {
+            return static_cast<Distribution>(i);
+        }
+    }
+    throw std::invalid_argument("Unknown distribution: " + name);
+}
+
+/**
+ * @brief Returns the name of a distribution, eg. "uniform" or "zipf".
+ */
+std::string distributionName(Distribution distribution) {
+    return NAMES[static_cast<size_t>(distribution)];
+}
+
+/**
+ * @brief Constructs a stream over the Players of an <count>-Player workload.
+ */
+WorkloadPlayerStream::WorkloadPlayerStream(const WorkloadSpec& spec, size_t count)
+    : spec_ { spec }
+    , count_ { count }
+    , currentIndex_ { 0 }
+{
+}
+
+/**
+ * @brief Generates the next Player in the stream.
+ *
+ * @throws std::runtime_error If there are no more players remaining in the stream.
+ */
+Player WorkloadPlayerStream::nextPlayer() {
+    if (currentIndex_ >= count_) {
+        throw std::runtime_error("No more players remaining in the stream.");
+    }
+    Player player("p" + std::to_string(currentIndex_), workloadLevel(spec_, count_, currentIndex_));
+    player.id_ = currentIndex_++;
+    return player;
+}
+
+/**
+ * @brief Returns the number of players remaining in the stream.
+ */
+size_t WorkloadPlayerStream::remaining() const {
+    return count_ - currentIndex_;
+}
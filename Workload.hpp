@@ -0,0 +1,98 @@
+#pragma once
+#include "Player.hpp"
+#include "PlayerStream.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The level distributions a synthetic workload can draw from.
+ */
+enum class Distribution {
+    Uniform, // Uniform over [0, maxLevel_]
+    Zipf, // Power law over [1, maxLevel_] with exponent zipfSkew_; low levels dominate
+    Normal, // Mean maxLevel_ / 2, standard deviation maxLevel_ / 8, clamped to [0, maxLevel_]
+    Ascending, // Levels rise steadily from 0 to maxLevel_ over the stream
+    Descending, // Levels fall steadily from maxLevel_ to 0 over the stream
+    FewDistinct, // Only distinct_ evenly spaced levels in [0, maxLevel_]
+    // Musser's median-of-3 killer permutation of 1..N (ignores maxLevel_). It
+    // defeats pivots chosen as the median of the first, middle & last elements,
+    // not pseudomedians of 9 such as BlockSort's.
+    QuickselectKiller
+};
+
+/**
+ * @brief Describes a synthetic workload of Players.
+ *
+ * Every Player is a pure function of (spec, N, index): Player i has id_ i,
+ * name_ "p<i>" & a level drawn by hashing <seed_> with i. Output is therefore
+ * identical for a given seed no matter how many threads generate it.
+ */
+struct WorkloadSpec {
+    Distribution distribution_ = Distribution::Uniform;
+    uint64_t seed_ = 1;
+    size_t maxLevel_ = 1000000;
+    double zipfSkew_ = 1.0;
+    size_t distinct_ = 16;
+};
+
+/**
+ * @brief Returns the level of Player <index> of an <count>-Player workload.
+ */
+size_t workloadLevel(const WorkloadSpec& spec, size_t count, size_t index);
+
+/**
+ * @brief Fills levels[0, count) with the levels of an <count>-Player workload.
+ *
+ * @param threads The number of threads to use; 0 uses every core
+ */
+void fillWorkloadLevels(const WorkloadSpec& spec, uint64_t* levels, size_t count, size_t threads = 0);
+
+/**
+ * @brief Generates the Players of an <count>-Player workload.
+ *
+ * @param threads The number of threads to use; 0 uses every core
+ */
+std::vector<Player> generateWorkload(const WorkloadSpec& spec, size_t count, size_t threads = 0);
+
+/**
+ * @brief Parses a distribution name, as printed by distributionName().
+ *
+ * @throws std::invalid_argument if <name> names no distribution.
+ */
+Distribution parseDistribution(const std::string& name);
+
+/**
+ * @brief Returns the name of a distribution, eg. "uniform" or "zipf".
+ */
+std::string distributionName(Distribution distribution);
+
+/**
+ * @brief A PlayerStream generating the Players of a workload lazily, in order,
+ * without ever materializing them.
+ */
+class WorkloadPlayerStream final : public PlayerStream {
+private:
+    WorkloadSpec spec_;
+    size_t count_;
+    size_t currentIndex_;
+
+public:
+    /**
+     * @brief Constructs a stream over the Players of an <count>-Player workload.
+     */
+    WorkloadPlayerStream(const WorkloadSpec& spec, size_t count);
+
+    /**
+     * @brief Generates the next Player in the stream.
+     *
+     * @throws std::runtime_error If there are no more players remaining in the stream.
+     */
+    Player nextPlayer() override;
+
+    /**
+     * @brief Returns the number of players remaining in the stream.
+     */
+    size_t remaining() const override;
+};
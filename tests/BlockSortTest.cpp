@@ -0,0 +1,108 @@
+#include "BlockSort.hpp"
+#include "Check.hpp"
+#include "Leaderboard.hpp"
+#include "Workload.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace {
+auto identity = [](uint64_t x) { return x; };
+
+/**
+ * @brief The level sequences every test runs over: each distribution, plus the
+ * sorted, reversed & all-equal inputs that trip up naive pivots.
+ */
+std::vector<std::vector<uint64_t>> inputs(size_t count) {
+    std::vector<std::vector<uint64_t>> result;
+    const Distribution distributions[] = { Distribution::Uniform, Distribution::Zipf, Distribution::Normal, Distribution::Ascending,
+        Distribution::Descending, Distribution::FewDistinct, Distribution::QuickselectKiller };
+    for (Distribution distribution : distributions) {
+        WorkloadSpec spec;
+        spec.distribution_ = distribution;
+        std::vector<uint64_t> levels(count);
+        fillWorkloadLevels(spec, levels.data(), count, 1);
+        result.push_back(levels);
+    }
+    result.emplace_back(count, 7);
+    return result;
+}
+
+const size_t SIZES[] = { 0, 1, 2, 23, 24, 25, 64, 65, 127, 128, 129, 1000, 4096, 100003 };
+
+void sortMatchesStdSort() {
+    for (size_t count : SIZES) {
+        for (std::vector<uint64_t> levels : inputs(count)) {
+            std::vector<uint64_t> expected = levels;
+            std::sort(expected.begin(), expected.end());
+            BlockSort::sort(levels.begin(), levels.end(), identity);
+            CHECK(levels == expected);
+        }
+    }
+}
+
+void selectMatchesStdSort() {
+    for (size_t count : SIZES) {
+        if (count == 0) {
+            continue;
+        }
+        for (const std::vector<uint64_t>& levels : inputs(count)) {
+            std::vector<uint64_t> expected = levels;
+            std::sort(expected.begin(), expected.end());
+            for (size_t nth : { size_t(0), count / 10, count / 2, count - (count + 9) / 10, count - 1 }) {
+                std::vector<uint64_t> selected = levels;
+                BlockSort::select(selected.begin(), selected.begin() + nth, selected.end(), identity);
+                CHECK(selected[nth] == expected[nth]);
+                CHECK(std::all_of(selected.begin(), selected.begin() + nth, [&](uint64_t x) { return x <= selected[nth]; }));
+                CHECK(std::all_of(selected.begin() + nth, selected.end(), [&](uint64_t x) { return x >= selected[nth]; }));
+                std::sort(selected.begin(), selected.end());
+                CHECK(selected == expected);
+            }
+        }
+    }
+}
+
+void partitionSplitsOnPredicate() {
+    for (size_t count : SIZES) {
+        for (std::vector<uint64_t> levels : inputs(count)) {
+            std::vector<uint64_t> expected = levels;
+            std::sort(expected.begin(), expected.end());
+            uint64_t pivot = count == 0 ? 0 : expected[count / 3];
+            auto below = [&](uint64_t x) { return x < pivot; };
+
+            auto split = BlockSort::partition(levels.begin(), levels.end(), below);
+            CHECK(split - levels.begin() == std::lower_bound(expected.begin(), expected.end(), pivot) - expected.begin());
+            CHECK(std::is_partitioned(levels.begin(), levels.end(), below));
+            std::sort(levels.begin(), levels.end());
+            CHECK(levels == expected);
+        }
+    }
+}
+
+void blockQuickSelectRankMatchesQuickSelectRank() {
+    for (size_t count : { 0, 1, 9, 10, 11, 1000, 100000 }) {
+        for (Distribution distribution : { Distribution::Uniform, Distribution::FewDistinct, Distribution::QuickselectKiller }) {
+            WorkloadSpec spec;
+            spec.distribution_ = distribution;
+            std::vector<Player> players = generateWorkload(spec, count, 1);
+            std::vector<Player> copy = players;
+
+            std::vector<Player> expected = Offline::quickSelectRank(copy).top_;
+            std::vector<Player> actual = Offline::blockQuickSelectRank(players).top_;
+            CHECK(actual.size() == expected.size());
+            for (size_t i = 0; i < actual.size() && i < expected.size(); ++i) {
+                CHECK(actual[i].level_ == expected[i].level_);
+            }
+        }
+    }
+}
+}
+
+int main() {
+    sortMatchesStdSort();
+    selectMatchesStdSort();
+    partitionSplitsOnPredicate();
+    blockQuickSelectRankMatchesQuickSelectRank();
+    return checkResult("BlockSortTest");
+}
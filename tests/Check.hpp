@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdio>
+
+/**
+ * @brief Minimal assertions for the test programs under tests/.
+ *
+ * CHECK() records a failure (with its location) & carries on, so one run
+ * reports every broken property; each test's main() returns checkResult(),
+ * which is non-zero if any CHECK() failed.
+ */
+namespace Check {
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline void fail(const char* expression, const char* file, int line) {
+    std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expression);
+    failures()++;
+}
+}
+
+#define CHECK(expression) ((expression) ? (void)0 : Check::fail(#expression, __FILE__, __LINE__))
+
+/**
+ * @brief Prints a summary for the test program <name> & returns its exit code.
+ */
+inline int checkResult(const char* name) {
+    if (Check::failures() > 0) {
+        std::fprintf(stderr, "%s: %d check(s) failed\n", name, Check::failures());
+        return 1;
+    }
+    std::printf("%s: passed\n", name);
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "Check.hpp"
+#include "CsvPlayerStream.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+bool parseThrows(const std::string& text) {
+    try {
+        Csv::parseUnsigned(text.data(), text.data() + text.size());
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Returns false if replaying <text> throws, otherwise collects its Players.
+ */
+bool replays(const std::string& text, std::vector<Player>& players, char delimiter = ',', bool hasHeader = false) {
+    players.clear();
+    try {
+        CsvPlayerStream stream(text.data(), text.size(), delimiter, hasHeader);
+        while (stream.remaining() > 0) {
+            players.push_back(stream.nextPlayer());
+        }
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+    return true;
+}
+
+void parsesEveryWidth() {
+    std::string digits;
+    size_t value = 0;
+    for (int width = 1; width <= 19; ++width) {
+        digits += static_cast<char>('0' + width % 10);
+        value = value * 10 + width % 10;
+        CHECK(Csv::parseUnsigned(digits.data(), digits.data() + digits.size()) == value);
+
+        // The same number ending the buffer, & followed by enough bytes for a wide load
+        std::string line = "p," + digits + "," + digits;
+        for (const std::string& text : { line, line + "\n" + std::string(32, 'q') + ",1\n" }) {
+            std::vector<Player> players;
+            CHECK(replays(text, players));
+            CHECK(!players.empty() && players[0].level_ == value && players[0].id_ == value);
+        }
+
+        // A stray byte at every position is rejected
+        for (size_t i = 0; i < digits.size(); ++i) {
+            std::string bad = digits;
+            bad[i] = 'x';
+            CHECK(parseThrows(bad));
+            bad[i] = '/';
+            CHECK(parseThrows(bad + std::string(16, '0')));
+
+            // Also when the stream could load the field with one wide read
+            std::vector<Player> players;
+            CHECK(!replays("p," + bad + ",1\n" + std::string(32, 'q') + ",1\n", players));
+            CHECK(!replays("p,1," + bad + "\n" + std::string(32, 'q') + ",1\n", players));
+        }
+    }
+    CHECK(parseThrows(""));
+    CHECK(parseThrows("12345678901234567890"));
+}
+
+void parsesRecords() {
+    std::vector<Player> players;
+    CHECK(replays("Rykard,23\r\n\n\r\nMalenia,99,7\n\n", players));
+    CHECK(players.size() == 2);
+    CHECK(players[0].name_ == "Rykard" && players[0].level_ == 23 && players[0].id_ == 0);
+    CHECK(players[1].name_ == "Malenia" && players[1].level_ == 99 && players[1].id_ == 7);
+
+    CHECK(replays("name\tlevel\tid\nRadahn\t80\t3", players, '\t', true));
+    CHECK(players.size() == 1 && players[0].name_ == "Radahn" && players[0].id_ == 3);
+
+    CHECK(replays(",0", players));
+    CHECK(players.size() == 1 && players[0].name_.empty() && players[0].level_ == 0);
+
+    CHECK(replays("", players) && players.empty());
+    for (const char* bad : { "Rykard", "Rykard,", "Rykard,2x3", "Rykard,23,", "Rykard,23,4,5", "Rykard,-1" }) {
+        CHECK(!replays(bad, players));
+    }
+}
+
+void batchesMatchSingles() {
+    std::string text;
+    for (size_t i = 0; i < 1000; ++i) {
+        text += "player" + std::string(i % 40, 'x') + "," + std::to_string(i * 7919) + "," + std::to_string(i) + "\n";
+        if (i % 17 == 0) {
+            text += "\r\n";
+        }
+    }
+    std::vector<Player> players;
+    CHECK(replays(text, players) && players.size() == 1000);
+
+    CsvPlayerStream stream(text.data(), text.size());
+    std::vector<Player> batch;
+    size_t seen = 0;
+    while (stream.nextBatch(batch, 333) > 0) {
+        for (const Player& player : batch) {
+            CHECK(seen < players.size() && player.name_ == players[seen].name_ && player.level_ == players[seen].level_
+                && player.id_ == players[seen].id_);
+            seen++;
+        }
+    }
+    CHECK(seen == players.size() && stream.remaining() == 0);
+}
+}
+
+int main() {
+    parsesEveryWidth();
+    parsesRecords();
+    batchesMatchSingles();
+    return checkResult("CsvPlayerStreamTest");
+}
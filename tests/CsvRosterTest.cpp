@@ -0,0 +1,152 @@
+#include "Check.hpp"
+#include "CsvPlayerStream.hpp"
+#include "CsvRoster.hpp"
+#include "Leaderboard.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+/**
+ * @brief A roster of <count> records with distinct levels, mixing long &
+ * short lines, CRLF endings, blank lines (both kinds) & missing ids.
+ */
+std::string sampleRoster(size_t count, char delimiter, bool header, size_t nameLength = 0) {
+    std::string text = header ? "name" + std::string(1, delimiter) + "level" + std::string(1, delimiter) + "id\n" : "";
+    for (size_t i = 0; i < count; ++i) {
+        std::string name = "player" + std::string(nameLength + i % 37, 'x') + std::to_string(i);
+        text += name + delimiter + std::to_string((i * 2654435761ULL) % 4294967311ULL);
+        if (i % 4 != 0) {
+            text += delimiter + std::to_string(i * 3);
+        }
+        text += i % 3 == 0 ? "\r\n" : "\n";
+        if (i % 11 == 0) {
+            text += "\n\r\n";
+        }
+    }
+    return text;
+}
+
+std::vector<Player> readStream(const std::string& text, char delimiter, bool header) {
+    CsvPlayerStream stream(text.data(), text.size(), delimiter, header);
+    std::vector<Player> players;
+    while (stream.remaining() > 0) {
+        players.push_back(stream.nextPlayer());
+    }
+    return players;
+}
+
+bool samePlayer(const Player& a, const Player& b) {
+    return a.name_ == b.name_ && a.level_ == b.level_ && a.id_ == b.id_;
+}
+
+/**
+ * @brief Checks that <roster> holds exactly <players>, in order, both
+ * through player(row) & through its level columns.
+ */
+void checkRoster(const CsvRoster& roster, const std::vector<Player>& players) {
+    CHECK(roster.size() == players.size());
+    for (size_t row = 0; row < roster.size() && row < players.size(); ++row) {
+        CHECK(samePlayer(roster.player(row), players[row]));
+    }
+
+    size_t nextRow = 0;
+    for (const LevelColumn& column : roster.levelColumns()) {
+        CHECK(column.firstRow_ == nextRow);
+        for (size_t i = 0; i < column.size_ && nextRow + i < players.size(); ++i) {
+            CHECK(column.levels_[i] == players[nextRow + i].level_);
+        }
+        nextRow += column.size_;
+    }
+    CHECK(nextRow == players.size());
+}
+
+void splitsMatchTheStream() {
+    for (char delimiter : { ',', '\t' }) {
+        for (bool header : { false, true }) {
+            std::string text = sampleRoster(5000, delimiter, header);
+            std::vector<Player> players = readStream(text, delimiter, header);
+            CHECK(players.size() == 5000);
+
+            // Also without a final newline
+            std::string unterminated = text.substr(0, text.find_last_not_of("\r\n") + 1);
+            for (size_t threads : { 1, 2, 3, 7, 16, 48 }) {
+                CsvRoster roster = parseCsvRoster(text.data(), text.size(), threads, delimiter, header);
+                CHECK(roster.chunks().size() == threads);
+                checkRoster(roster, players);
+                checkRoster(parseCsvRoster(unterminated.data(), unterminated.size(), threads, delimiter, header), players);
+            }
+        }
+    }
+}
+
+void fewerRecordsThanThreads() {
+    // Three records long enough to be split eight ways, so most chunks are empty
+    std::string text = sampleRoster(3, ',', true, 12000);
+    std::vector<Player> players = readStream(text, ',', true);
+    CsvRoster roster = parseCsvRoster(text.data(), text.size(), 8, ',', true);
+    CHECK(roster.chunks().size() == 8);
+    checkRoster(roster, players);
+
+    std::string headerOnly = "name,level\n";
+    CHECK(parseCsvRoster(headerOnly.data(), headerOnly.size(), 4, ',', true).size() == 0);
+    CHECK(parseCsvRoster("", 0, 4).size() == 0);
+}
+
+void rejectsMalformedRecords() {
+    std::string text = sampleRoster(5000, ',', false);
+    text.insert(text.size() * 3 / 4, "\nmissing-level\n"); // Lands in a later chunk
+    bool threw = false;
+    try {
+        parseCsvRoster(text.data(), text.size(), 4);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+void loadsFiles() {
+    std::string path = "/tmp/CsvRosterTest-" + std::to_string(::getpid()) + ".csv";
+    std::string text = sampleRoster(3000, ',', true);
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << text;
+    }
+    CsvRoster roster = loadCsvRoster(path, 5, ',', true);
+    std::remove(path.c_str()); // The mapping stays valid
+    checkRoster(roster, readStream(text, ',', true));
+}
+
+void enginesMatchQuickSelectRank() {
+    // Top 10% of 1..65 Players goes through SmallTopK; larger ones by quickselect or heap
+    for (size_t count : { 0, 1, 9, 640, 651, 5000 }) {
+        std::string text = sampleRoster(count, ',', false);
+        std::vector<Player> players = readStream(text, ',', false);
+        RankingResult expected = Offline::quickSelectRank(players);
+
+        for (size_t threads : { 1, 3 }) {
+            CsvRoster roster = parseCsvRoster(text.data(), text.size(), threads);
+            for (const RankingResult& result : { Offline::quickSelectRank(roster), Offline::heapRank(roster) }) {
+                CHECK(result.top_.size() == expected.top_.size());
+                CHECK(result.cutoffs_.empty());
+                for (size_t i = 0; i < result.top_.size() && i < expected.top_.size(); ++i) {
+                    CHECK(samePlayer(result.top_[i], expected.top_[i]));
+                }
+            }
+        }
+    }
+}
+}
+
+int main() {
+    splitsMatchTheStream();
+    fewerRecordsThanThreads();
+    rejectsMalformedRecords();
+    loadsFiles();
+    enginesMatchQuickSelectRank();
+    return checkResult("CsvRosterTest");
+}
@@ -0,0 +1,128 @@
+#include "Check.hpp"
+#include "ExternalRank.hpp"
+#include "PlayerFile.hpp"
+#include "Workload.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <dirent.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+std::string spillDirectory() {
+    return "/tmp";
+}
+
+/**
+ * @brief Returns the number of spill runs this process has left behind.
+ */
+size_t leftoverRuns() {
+    std::string prefix = "external-run-" + std::to_string(::getpid()) + "-";
+    size_t count = 0;
+    if (DIR* dir = ::opendir(spillDirectory().c_str())) {
+        while (dirent* entry = ::readdir(dir)) {
+            count += std::string(entry->d_name).compare(0, prefix.size(), prefix) == 0;
+        }
+        ::closedir(dir);
+    }
+    return count;
+}
+
+std::vector<size_t> levelsOf(const std::vector<Player>& players) {
+    std::vector<size_t> levels;
+    for (const Player& player : players) {
+        levels.push_back(player.level_);
+    }
+    return levels;
+}
+
+/**
+ * @brief Ranks <players> externally within <budget> & checks the levels ranked
+ * match quickSelectRank() over a copy.
+ */
+void checkAgainstQuickSelect(const std::vector<Player>& players, size_t budget) {
+    std::vector<Player> copy = players;
+    std::vector<size_t> expected = levelsOf(Offline::quickSelectRank(copy).top_);
+
+    ExternalRankingOptions options;
+    options.memoryBudget_ = budget;
+    options.spillDirectory_ = spillDirectory();
+    VectorPlayerStream stream(players);
+    ExternalRankingResult result = Offline::externalRank(stream, options);
+
+    CHECK(stream.remaining() == 0);
+    CHECK(result.topCount_ == expected.size());
+    std::vector<size_t> actual;
+    if (result.outputPath_.empty()) {
+        CHECK(result.runs_ == 0);
+        actual = levelsOf(result.ranking_.top_);
+    } else {
+        CHECK(result.runs_ > 0);
+        CHECK(result.ranking_.top_.empty());
+        PlayerFile file(result.outputPath_);
+        for (size_t i = 0; i < file.size(); ++i) {
+            actual.push_back(file.player(i).level_);
+        }
+        std::remove(result.outputPath_.c_str());
+    }
+    CHECK(actual == expected);
+    CHECK(leftoverRuns() == 0);
+}
+
+void matchesQuickSelect() {
+    const Distribution distributions[] = { Distribution::Uniform, Distribution::FewDistinct, Distribution::Ascending };
+    for (Distribution distribution : distributions) {
+        WorkloadSpec spec;
+        spec.distribution_ = distribution;
+        for (size_t count : { 0, 1, 9, 1000, 200000 }) {
+            std::vector<Player> players = generateWorkload(spec, count, 1);
+            for (size_t budget : { size_t(4) << 10, size_t(1) << 20, size_t(256) << 20 }) {
+                checkAgainstQuickSelect(players, budget);
+            }
+        }
+    }
+}
+
+void spillsWithinBudget() {
+    std::vector<Player> players = generateWorkload(WorkloadSpec(), 200000, 1);
+    ExternalRankingOptions options;
+    options.memoryBudget_ = size_t(1) << 20;
+    options.spillDirectory_ = spillDirectory();
+    VectorPlayerStream stream(players);
+    ExternalRankingResult result = Offline::externalRank(stream, options);
+
+    CHECK(result.runs_ > 0);
+    CHECK(result.peakMemory_ > 0);
+    CHECK(result.peakMemory_ <= options.memoryBudget_);
+    CHECK(result.bytesRead_ > 0);
+    CHECK(result.bytesWritten_ > result.bytesRead_ / 2);
+    std::remove(result.outputPath_.c_str());
+}
+
+void defaultOutputPathsAreUnique() {
+    std::vector<Player> players = generateWorkload(WorkloadSpec(), 50000, 1);
+    ExternalRankingOptions options;
+    options.memoryBudget_ = size_t(64) << 10;
+    options.spillDirectory_ = spillDirectory();
+
+    VectorPlayerStream first(players);
+    VectorPlayerStream second(players);
+    ExternalRankingResult a = Offline::externalRank(first, options);
+    ExternalRankingResult b = Offline::externalRank(second, options);
+    CHECK(!a.outputPath_.empty());
+    CHECK(a.outputPath_ != b.outputPath_);
+    CHECK(PlayerFile(a.outputPath_).size() == a.topCount_);
+    CHECK(PlayerFile(b.outputPath_).size() == b.topCount_);
+    std::remove(a.outputPath_.c_str());
+    std::remove(b.outputPath_.c_str());
+}
+}
+
+int main() {
+    matchesQuickSelect();
+    spillsWithinBudget();
+    defaultOutputPathsAreUnique();
+    return checkResult("ExternalRankTest");
+}
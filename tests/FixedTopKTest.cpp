@@ -0,0 +1,97 @@
+#include "Check.hpp"
+#include "FixedTopK.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+/**
+ * @brief Random, ascending, descending & heavily tied streams of <count> Players.
+ */
+std::vector<std::vector<Player>> sampleStreams(size_t count) {
+    std::mt19937_64 rng(count);
+    std::vector<std::vector<Player>> streams(4);
+    for (size_t i = 0; i < count; ++i) {
+        std::string name = "player" + std::to_string(i);
+        streams[0].emplace_back(name, rng() % 1000);
+        streams[1].emplace_back(name, i);
+        streams[2].emplace_back(name, count - i);
+        streams[3].emplace_back(name, rng() % 5);
+    }
+    return streams;
+}
+
+std::vector<size_t> levels(const std::vector<Player>& players) {
+    std::vector<size_t> result;
+    for (const Player& player : players) {
+        result.push_back(player.level_);
+    }
+    return result;
+}
+
+/**
+ * @brief Checks rankIncomingFixed<K> & fixedTopRank<K> against rankIncoming(stream, K).
+ */
+template <size_t K>
+void matchesRankIncoming() {
+    for (size_t count : { size_t(0), size_t(1), K - 1, K, K + 1, size_t(1000) }) {
+        for (const std::vector<Player>& players : sampleStreams(count)) {
+            VectorPlayerStream expectedStream(players);
+            RankingResult expected = Online::rankIncoming(expectedStream, K);
+
+            VectorPlayerStream stream(players);
+            RankingResult fixed = Online::rankIncomingFixed<K>(stream);
+            CHECK(stream.remaining() == 0);
+            CHECK(levels(fixed.top_) == levels(expected.top_));
+            CHECK(fixed.cutoffs_ == expected.cutoffs_);
+
+            // Read by reference
+            PlayerSpanStream span(players);
+            RankingResult borrowed = Online::rankIncomingFixed<K>(span);
+            CHECK(levels(borrowed.top_) == levels(expected.top_));
+            CHECK(borrowed.cutoffs_ == expected.cutoffs_);
+
+            RankingResult offline = Offline::fixedTopRank<K>(players);
+            CHECK(levels(offline.top_) == levels(expected.top_));
+            CHECK(offline.cutoffs_.empty());
+        }
+    }
+}
+
+/**
+ * @brief Ties with the cutoff are rejected once the board is full, & the
+ * board stays sorted with each Player beside its level.
+ */
+template <size_t K>
+void rejectsTiesAtTheCutoff() {
+    FixedTopK<K> board;
+    for (size_t i = 0; i < K; ++i) {
+        CHECK(board.push(Player("p" + std::to_string(i), 7)));
+    }
+    CHECK(board.full() && board.cutoff() == 7);
+    CHECK(!board.push(Player("tie", 7)));
+    CHECK(!board.push(Player("below", 6)));
+    CHECK(board.push(Player("above", 8)));
+    CHECK(board[K - 1].name_ == "above" && board[K - 1].level_ == 8);
+    for (size_t i = 0; i + 1 < K; ++i) {
+        CHECK(board[i].level_ == 7 && board[i].name_ != "tie");
+    }
+}
+}
+
+int main() {
+    static_assert(FixedTopK<1>::UNROLL_LIMIT == 32, "The cases below straddle the unroll limit");
+    matchesRankIncoming<1>();
+    matchesRankIncoming<3>();
+    matchesRankIncoming<10>();
+    matchesRankIncoming<32>(); // The largest unrolled board
+    matchesRankIncoming<33>(); // The smallest binary-searched board
+    matchesRankIncoming<50>();
+    matchesRankIncoming<100>();
+    rejectsTiesAtTheCutoff<1>();
+    rejectsTiesAtTheCutoff<32>();
+    rejectsTiesAtTheCutoff<33>();
+    return checkResult("FixedTopKTest");
+}
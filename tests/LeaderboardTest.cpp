@@ -0,0 +1,285 @@
+#include "Check.hpp"
+#include "Leaderboard.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+/**
+ * @brief Streams of every shape the online engines special-case: random,
+ * ascending (the adaptive engine's buffered mode), descending & mixed.
+ */
+std::vector<std::vector<Player>> sampleStreams(size_t count) {
+    std::mt19937_64 rng(42);
+    std::vector<std::vector<Player>> streams(4);
+    for (size_t i = 0; i < count; ++i) {
+        std::string name = "player" + std::to_string(i);
+        streams[0].emplace_back(name, rng() % 500);
+        streams[1].emplace_back(name, i);
+        streams[2].emplace_back(name, count - i);
+        streams[3].emplace_back(name, i % 300 < 150 ? i : rng() % 50);
+    }
+    return streams;
+}
+
+std::vector<size_t> levels(const std::vector<Player>& players) {
+    std::vector<size_t> result;
+    for (const Player& player : players) {
+        result.push_back(player.level_);
+    }
+    return result;
+}
+
+/**
+ * @brief The <capacity(count)>-th highest level among the first <count>
+ * Players, for every milestone a stream of <players> should report.
+ */
+std::unordered_map<size_t, size_t> expectedCutoffs(const std::vector<Player>& players, size_t reporting_interval,
+    const std::function<size_t(size_t)>& capacity) {
+    std::unordered_map<size_t, size_t> cutoffs;
+    for (size_t count = 1; count <= players.size(); ++count) {
+        if (count % reporting_interval != 0 && count != players.size()) {
+            continue;
+        }
+        std::vector<size_t> prefix = levels(std::vector<Player>(players.begin(), players.begin() + count));
+        std::sort(prefix.begin(), prefix.end(), std::greater<size_t>());
+        cutoffs[count] = prefix[std::min(capacity(count), count) - 1];
+    }
+    return cutoffs;
+}
+
+/**
+ * @brief The ascending levels of the <topCount> highest leveled <players>.
+ */
+std::vector<size_t> expectedTop(const std::vector<Player>& players, size_t topCount) {
+    std::vector<size_t> sorted = levels(players);
+    std::sort(sorted.begin(), sorted.end());
+    return std::vector<size_t>(sorted.end() - std::min(topCount, sorted.size()), sorted.end());
+}
+
+/**
+ * @brief Counts for a replaceMin() of <target> into the min-heap 1..7, whose
+ * complete tree makes every percolation path (& so every count) exact.
+ */
+RankingStats replaceMinStats(size_t target) {
+    std::vector<Player> heap;
+    for (size_t level = 1; level <= 7; ++level) {
+        heap.emplace_back("p" + std::to_string(level), level);
+    }
+    Player incoming("incoming", target);
+    CountingInstrumentation counter;
+    Online::replaceMin(heap.begin(), heap.end(), incoming, counter);
+    return counter.stats();
+}
+
+void countingInstrumentationCounts() {
+    // A root that stays put: both children compared, nothing swapped
+    RankingStats stays = replaceMinStats(0);
+    CHECK(stays.comparisons_ == 2 && stays.swaps_ == 0 && stays.moves_ == 1);
+    CHECK(stays.siftDepth_ == 0 && stays.maxSiftDepth_ == 0 && stays.allocations_ == 0);
+
+    // A root that sinks to a leaf: 2 comparisons & a swap at each internal level
+    RankingStats sinks = replaceMinStats(10);
+    CHECK(sinks.comparisons_ == 4 && sinks.swaps_ == 2 && sinks.moves_ == 1);
+    CHECK(sinks.siftDepth_ == 2 && sinks.maxSiftDepth_ == 2 && sinks.allocations_ == 0);
+
+    // Ascending levels make every Player after the first 7 displace the root of
+    // a full 7-Player heap & sink to a leaf. make_heap() & the final sort()
+    // add a bounded number of comparisons on top of the exact per-Player ones.
+    const size_t count = 70;
+    const size_t capacity = 7;
+    std::vector<Player> players = sampleStreams(count)[1];
+    PlayerSpanStream stream(players);
+    CountingInstrumentation counter;
+    RankingStats online = Online::rankIncoming(stream, capacity, counter).stats_;
+    size_t displaced = count - capacity;
+    CHECK(online.allocations_ == 1);
+    CHECK(online.moves_ == capacity + 2 * displaced);
+    CHECK(online.swaps_ == 2 * displaced);
+    CHECK(online.siftDepth_ == 2 * displaced && online.maxSiftDepth_ == 2);
+    CHECK(online.comparisons_ >= 5 * displaced && online.comparisons_ <= 5 * displaced + 2 * capacity + capacity * capacity);
+
+    // The offline engines: one result buffer, topCount Players moved into it,
+    // & at least one comparison per Player to select them
+    for (const std::vector<Player>& stream : sampleStreams(1000)) {
+        std::vector<Player> copy(stream);
+        CountingInstrumentation quick;
+        RankingStats selected = Offline::quickSelectRank(copy, quick).stats_;
+        CHECK(selected.allocations_ == 1 && selected.moves_ == 100);
+        CHECK(selected.comparisons_ >= 999 && selected.comparisons_ <= 20 * 1000);
+        CHECK(selected.swaps_ == 0 && selected.siftDepth_ == 0);
+
+        copy = stream;
+        CountingInstrumentation heap;
+        RankingStats heaped = Offline::heapRank(copy, heap).stats_;
+        CHECK(heaped.allocations_ == 1 && heaped.moves_ == 100);
+        CHECK(heaped.comparisons_ >= 999 && heaped.comparisons_ <= 20 * 1000);
+    }
+}
+
+void rankIncomingMatchesReference() {
+    for (size_t count : { 0, 1, 7, 64, 1000 }) {
+        for (const std::vector<Player>& players : sampleStreams(count)) {
+            for (size_t interval : { 1, 3, 10, 64, 100, 2000 }) {
+                auto fixed = [interval](size_t) { return interval; };
+                VectorPlayerStream stream(players);
+                RankingResult result = Online::rankIncoming(stream, interval);
+                CHECK(stream.remaining() == 0);
+                CHECK(levels(result.top_) == expectedTop(players, interval));
+                CHECK(result.cutoffs_ == expectedCutoffs(players, interval, fixed));
+
+                PlayerSpanStream span(players);
+                RankingResult borrowed = Online::rankIncoming(span, interval);
+                CHECK(levels(borrowed.top_) == levels(result.top_) && borrowed.cutoffs_ == result.cutoffs_);
+            }
+        }
+    }
+}
+
+void adaptiveMatchesRankIncoming() {
+    for (size_t count : { 0, 1, 7, 64, 1000 }) {
+        for (const std::vector<Player>& players : sampleStreams(count)) {
+            for (size_t interval : { 1, 3, 10, 64, 100, 2000 }) {
+                auto fixed = [interval](size_t) { return interval; };
+                // Always, sometimes & never buffered
+                for (double threshold : { 0.0, 0.5, 2.0 }) {
+                    VectorPlayerStream stream(players);
+                    RankingResult result = Online::rankIncomingAdaptive(stream, interval, threshold);
+                    CHECK(stream.remaining() == 0);
+                    CHECK(levels(result.top_) == expectedTop(players, interval));
+                    CHECK(result.cutoffs_ == expectedCutoffs(players, interval, fixed));
+                }
+            }
+        }
+    }
+}
+
+void topFractionMatchesReference() {
+    auto tenth = [](size_t count) { return (count + 9) / 10; };
+    for (size_t count : { 0, 1, 9, 10, 11, 1000 }) {
+        for (const std::vector<Player>& players : sampleStreams(count)) {
+            for (size_t interval : { 1, 10, 64, 2000 }) {
+                VectorPlayerStream stream(players);
+                RankingResult result = Online::rankTopFraction(stream, interval);
+                CHECK(stream.remaining() == 0);
+                CHECK(levels(result.top_) == expectedTop(players, tenth(count)));
+                CHECK(result.cutoffs_ == expectedCutoffs(players, interval, tenth));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Checks that <view> holds exactly the <expected> levels & no cutoffs.
+ */
+void checkView(const RankingView& view, const std::vector<size_t>& expected) {
+    CHECK(view.cutoffs_ == nullptr && view.cutoffCount_ == 0);
+    CHECK(levels(std::vector<Player>(view.begin(), view.end())) == expected);
+}
+
+void inPlaceViewsMatchQuickSelectRank() {
+    Ranker ranker;
+    for (size_t count : { 0, 1, 9, 10, 11, 64, 1000 }) {
+        for (const std::vector<Player>& players : sampleStreams(count)) {
+            std::vector<Player> copy(players);
+            std::vector<size_t> expected = levels(Offline::quickSelectRank(copy).top_);
+            std::vector<size_t> everyLevel = levels(players);
+            std::sort(everyLevel.begin(), everyLevel.end());
+
+            for (auto rankInPlace : { Offline::quickSelectRankInPlace, Offline::heapRankInPlace }) {
+                std::vector<Player> board(players);
+                RankingView view = rankInPlace(board);
+                checkView(view, expected);
+
+                // The view is the tail of the caller's vector, which still holds every Player
+                CHECK(view.end() == board.data() + board.size());
+                std::vector<size_t> kept = levels(board);
+                std::sort(kept.begin(), kept.end());
+                CHECK(kept == everyLevel);
+            }
+
+            std::vector<Player> board(players);
+            checkView(ranker.rank(board), expected);
+        }
+    }
+}
+
+// Mirrors sampleSelectRank()'s fixed-seed sampler in Leaderboard.cpp
+constexpr size_t SAMPLE_SIZE = 4096;
+constexpr size_t SAMPLE_MIN_PLAYERS = 16 * SAMPLE_SIZE;
+
+uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Boards of <count> Players on which sampleSelectRank() takes each of
+ * its paths: random levels (the bracket holds), heavy ties straddling the
+ * cutoff (far more candidates than reserved), & levels planted so that every
+ * sampled Player outranks the rest (the bracket misses & it falls back).
+ */
+std::vector<std::vector<Player>> sampleSelectBoards(size_t count) {
+    std::mt19937_64 rng(5);
+    std::vector<std::vector<Player>> boards(4);
+    for (size_t i = 0; i < count; ++i) {
+        boards[0].emplace_back("p", rng() % (count / 4 + 1));
+        boards[1].emplace_back("p", 7);
+        boards[2].emplace_back("p", i % 20 == 0 ? 9 : (i % 20 < 5 ? 8 : rng() % 8));
+        boards[3].emplace_back("p", rng() % 1000);
+    }
+    for (size_t i = 0; i < SAMPLE_SIZE && count > 0; ++i) {
+        boards[3][static_cast<uint64_t>((static_cast<unsigned __int128>(splitmix64(i)) * count) >> 64)].level_ = 1000000;
+    }
+    return boards;
+}
+
+void sampleSelectMatchesQuickSelect() {
+    for (size_t count : { size_t(0), size_t(1), size_t(1000), SAMPLE_MIN_PLAYERS - 1, SAMPLE_MIN_PLAYERS,
+             SAMPLE_MIN_PLAYERS + 1, 2 * SAMPLE_MIN_PLAYERS + 7, size_t(300000) }) {
+        for (const std::vector<Player>& players : sampleSelectBoards(count)) {
+            std::vector<Player> copy = players;
+            std::vector<size_t> expected = levels(Offline::quickSelectRank(copy).top_);
+            for (size_t threads : { 1, 4 }) {
+                CHECK(levels(Offline::sampleSelectRank(players, threads).top_) == expected);
+            }
+        }
+    }
+}
+
+void rankerMatchesRankIncoming() {
+    Ranker ranker;
+    for (const std::vector<Player>& players : sampleStreams(1000)) {
+        for (size_t interval : { 3, 100 }) {
+            VectorPlayerStream expected(players);
+            RankingResult reference = Online::rankIncoming(expected, interval);
+
+            VectorPlayerStream stream(players);
+            RankingView view = ranker.rank(stream, interval);
+            CHECK(view.size_ == reference.top_.size());
+            for (size_t i = 0; i < view.size_ && i < reference.top_.size(); ++i) {
+                CHECK(view.top_[i].level_ == reference.top_[i].level_);
+            }
+            CHECK(ranker.take().cutoffs_ == reference.cutoffs_);
+        }
+    }
+}
+}
+
+int main() {
+    rankIncomingMatchesReference();
+    adaptiveMatchesRankIncoming();
+    topFractionMatchesReference();
+    rankerMatchesRankIncoming();
+    inPlaceViewsMatchQuickSelectRank();
+    sampleSelectMatchesQuickSelect();
+    countingInstrumentationCounts();
+    return checkResult("LeaderboardTest");
+}
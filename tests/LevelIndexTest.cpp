@@ -0,0 +1,130 @@
+#include "Check.hpp"
+#include "Leaderboard.hpp"
+#include "LevelIndex.hpp"
+#include "Workload.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+/**
+ * @brief Checks every query of <index> against <levels> sorted from the highest.
+ */
+void checkAgainstSorted(const LevelIndex& index, std::vector<size_t> levels) {
+    std::sort(levels.begin(), levels.end(), std::greater<size_t>());
+    CHECK(index.size() == levels.size());
+
+    for (size_t rank = 1; rank <= levels.size(); ++rank) {
+        CHECK(index.levelAtRank(rank) == levels[rank - 1]);
+    }
+    for (size_t level = 0; level <= index.maxLevel() + 1; ++level) {
+        // Levels sorted descending: those strictly above <level> form a prefix
+        size_t above = std::lower_bound(levels.begin(), levels.end(), level, std::greater<size_t>()) - levels.begin();
+        CHECK(index.countAbove(level) == above);
+        CHECK(index.rankOf(level) == above + 1);
+    }
+}
+
+bool throwsOutOfRange(const std::function<void()>& action) {
+    try {
+        action();
+    } catch (const std::out_of_range&) {
+        return true;
+    }
+    return false;
+}
+
+void builtIndexMatchesSortedCopy() {
+    for (Distribution distribution : { Distribution::Uniform, Distribution::Zipf, Distribution::FewDistinct }) {
+        WorkloadSpec spec;
+        spec.distribution_ = distribution;
+        spec.maxLevel_ = 5000;
+        for (size_t count : { 0, 1, 2, 1000, 20000 }) {
+            std::vector<Player> players = generateWorkload(spec, count, 1);
+            std::vector<size_t> levels;
+            for (const Player& player : players) {
+                levels.push_back(player.level_);
+            }
+            checkAgainstSorted(LevelIndex(players), levels);
+        }
+    }
+}
+
+void updatesMatchSortedCopy() {
+    std::mt19937_64 random(1);
+    for (size_t maxLevel : { 0, 1, 7, 8, 1000 }) {
+        LevelIndex index(maxLevel);
+        std::vector<size_t> levels;
+        for (size_t step = 0; step < 3000; ++step) {
+            size_t action = random() % 4;
+            size_t level = random() % (maxLevel + 1);
+            if (action < 2 || levels.empty()) {
+                index.add(level);
+                levels.push_back(level);
+            } else {
+                size_t i = random() % levels.size();
+                if (action == 2) {
+                    index.remove(levels[i]);
+                    levels.erase(levels.begin() + i);
+                } else {
+                    index.move(levels[i], level);
+                    levels[i] = level;
+                }
+            }
+            if (step % 500 == 0) {
+                checkAgainstSorted(index, levels);
+            }
+        }
+        checkAgainstSorted(index, levels);
+    }
+}
+
+void rejectsOutOfRangeLevels() {
+    LevelIndex index(10);
+    index.add(10);
+    CHECK(throwsOutOfRange([&]() { index.add(11); }));
+    CHECK(throwsOutOfRange([&]() { index.move(10, 11); }));
+    CHECK(throwsOutOfRange([&]() { index.levelAtRank(0); }));
+    CHECK(throwsOutOfRange([&]() { index.levelAtRank(2); }));
+    CHECK(index.size() == 1 && index.levelAtRank(1) == 10);
+
+    // Domains that would wrap the tree's size or need terabytes are refused up front
+    for (size_t level : { size_t(SIZE_MAX), SIZE_MAX - 1, size_t(1000000000000), LevelIndex::MAX_LEVEL + 1 }) {
+        CHECK(throwsOutOfRange([&]() { LevelIndex empty(level); }));
+        CHECK(throwsOutOfRange([&]() { LevelIndex built(std::vector<Player> { Player("p", 3), Player("q", level) }); }));
+    }
+}
+
+void rankIncomingIndexesEveryPlayer() {
+    std::vector<Player> players = generateWorkload(WorkloadSpec(), 10000, 1);
+    size_t highest = std::max_element(players.begin(), players.end())->level_;
+    LevelIndex index(highest);
+    VectorPlayerStream stream(players);
+    RankingResult result = Online::rankIncoming(stream, 1000, index);
+
+    CHECK(index.size() == players.size());
+    CHECK(result.top_.size() == 1000);
+    // The lowest Player on the board ranks exactly at the board's edge or better
+    CHECK(index.rankOf(result.top_.front().level_) <= result.top_.size());
+    CHECK(index.levelAtRank(1) == highest);
+
+    // A level beyond the index stops ingestion with the earlier Players indexed
+    LevelIndex small(100);
+    std::vector<Player> mixed { Player("a", 5), Player("b", 50), Player("c", 500), Player("d", 7) };
+    VectorPlayerStream mixedStream(mixed);
+    CHECK(throwsOutOfRange([&]() { Online::rankIncoming(mixedStream, 1, small); }));
+    CHECK(small.size() == 2);
+}
+}
+
+int main() {
+    builtIndexMatchesSortedCopy();
+    updatesMatchSortedCopy();
+    rejectsOutOfRangeLevels();
+    rankIncomingIndexesEveryPlayer();
+    return checkResult("LevelIndexTest");
+}
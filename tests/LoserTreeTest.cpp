@@ -0,0 +1,202 @@
+#include "Check.hpp"
+#include "Leaderboard.hpp"
+#include "LoserTree.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+/**
+ * @brief Returns <count> ascending runs of random lengths up to <maxLength>,
+ * with keys in [0, <range>).
+ */
+std::vector<std::vector<size_t>> randomRuns(std::mt19937_64& random, size_t count, size_t maxLength, size_t range) {
+    std::vector<std::vector<size_t>> runs(count);
+    for (std::vector<size_t>& run : runs) {
+        run.resize(random() % (maxLength + 1));
+        for (size_t& key : run) {
+            key = random() % range;
+        }
+        std::sort(run.begin(), run.end());
+    }
+    return runs;
+}
+
+void treeYieldsEveryKeyInOrder() {
+    std::mt19937_64 random(1);
+    for (size_t trial = 0; trial < 200; ++trial) {
+        std::vector<std::vector<size_t>> runs = randomRuns(random, 1 + trial % 17, 50, trial % 2 == 0 ? 8 : 1000);
+
+        // Pop each run from the back, so the tree yields the highest key first
+        std::vector<size_t> expected;
+        LoserTree<size_t> tree(runs.size());
+        for (size_t r = 0; r < runs.size(); ++r) {
+            expected.insert(expected.end(), runs[r].begin(), runs[r].end());
+            if (!runs[r].empty()) {
+                tree.set(r, runs[r].back());
+            }
+        }
+        tree.build();
+        std::sort(expected.begin(), expected.end(), std::greater<size_t>());
+
+        std::vector<size_t> merged;
+        size_t lastSource = 0;
+        while (!tree.empty()) {
+            size_t r = tree.winner();
+            CHECK(tree.top() == runs[r].back());
+            // Ties go to the lower source
+            CHECK(merged.empty() || merged.back() != tree.top() || r >= lastSource);
+            merged.push_back(runs[r].back());
+            lastSource = r;
+            runs[r].pop_back();
+            if (runs[r].empty()) {
+                tree.exhaust(r);
+            } else {
+                tree.set(r, runs[r].back());
+            }
+            tree.replay(r);
+        }
+        CHECK(merged == expected);
+    }
+}
+
+void emptyTrees() {
+    LoserTree<size_t> none(0);
+    none.build();
+    CHECK(none.empty());
+
+    LoserTree<size_t> exhausted(3);
+    exhausted.build();
+    CHECK(exhausted.empty());
+    CHECK(exhausted.size() == 3);
+}
+
+void rankingMergeMatchesSortedUnion() {
+    std::mt19937_64 random(2);
+    for (size_t trial = 0; trial < 100; ++trial) {
+        std::vector<RankingResult> parts;
+        std::vector<size_t> all;
+        for (const std::vector<size_t>& run : randomRuns(random, 1 + trial % 9, 40, trial % 2 == 0 ? 5 : 100000)) {
+            std::vector<Player> top;
+            for (size_t level : run) {
+                top.emplace_back("p", level);
+                all.push_back(level);
+            }
+            parts.emplace_back(std::move(top), std::unordered_map<size_t, size_t>(), 0.0);
+        }
+        std::sort(all.begin(), all.end());
+
+        for (size_t k : { size_t(0), size_t(1), all.size() / 2, all.size(), all.size() + 5 }) {
+            RankingResult merged = RankingResult::merge(parts, k);
+            std::vector<size_t> expected(all.end() - std::min(k, all.size()), all.end());
+            std::vector<size_t> levels;
+            for (const Player& player : merged.top_) {
+                levels.push_back(player.level_);
+            }
+            CHECK(levels == expected);
+        }
+    }
+}
+
+/**
+ * @brief A (key, run) pair, so stability across runs can be checked.
+ */
+using Tagged = std::pair<size_t, size_t>;
+auto keyOf = [](const Tagged& x) { return x.first; };
+
+/**
+ * @brief Tags every key of <runs> with its run & returns the expected merge:
+ * a stable sort of the runs concatenated in order.
+ */
+std::vector<std::vector<Tagged>> tag(const std::vector<std::vector<size_t>>& runs, std::vector<Tagged>& expected) {
+    std::vector<std::vector<Tagged>> tagged(runs.size());
+    for (size_t r = 0; r < runs.size(); ++r) {
+        for (size_t key : runs[r]) {
+            tagged[r].emplace_back(key, r);
+        }
+        expected.insert(expected.end(), tagged[r].begin(), tagged[r].end());
+    }
+    std::stable_sort(expected.begin(), expected.end(), [](const Tagged& a, const Tagged& b) { return a.first < b.first; });
+    return tagged;
+}
+
+using TaggedRun = Merge::Run<std::vector<Tagged>::const_iterator>;
+
+std::vector<TaggedRun> spans(const std::vector<std::vector<Tagged>>& tagged) {
+    std::vector<TaggedRun> runs;
+    for (const std::vector<Tagged>& run : tagged) {
+        runs.emplace_back(run.begin(), run.end());
+    }
+    return runs;
+}
+
+void mergesMatchStableSort() {
+    std::mt19937_64 random(3);
+    for (size_t trial = 0; trial < 200; ++trial) {
+        std::vector<Tagged> expected;
+        std::vector<std::vector<Tagged>> tagged = tag(randomRuns(random, 1 + trial % 13, trial % 3 == 0 ? 5000 : 60, trial % 2 == 0 ? 4 : 1 << 20), expected);
+        std::vector<TaggedRun> runs = spans(tagged);
+
+        for (size_t limit : { size_t(0), expected.size() / 3, expected.size(), expected.size() + 1 }) {
+            size_t outputs = std::min(limit, expected.size());
+            std::vector<Tagged> prefix(expected.begin(), expected.begin() + outputs);
+
+            std::vector<Tagged> serial(outputs);
+            CHECK(Merge::mergeRuns(runs, serial.begin(), limit, keyOf) == serial.end());
+            CHECK(serial == prefix);
+
+            // std::merge agrees when there are only two runs
+            if (tagged.size() == 2) {
+                std::vector<Tagged> merged(tagged[0].size() + tagged[1].size());
+                std::merge(tagged[0].begin(), tagged[0].end(), tagged[1].begin(), tagged[1].end(), merged.begin(),
+                    [](const Tagged& a, const Tagged& b) { return a.first < b.first; });
+                CHECK(std::equal(serial.begin(), serial.end(), merged.begin()));
+            }
+
+            // Large trials split the output across threads; small ones merge serially
+            for (size_t threads : { 2, 3, 8 }) {
+                std::vector<Tagged> parallel(outputs);
+                CHECK(Merge::parallelMergeRuns(runs, parallel.begin(), limit, threads, keyOf) == parallel.end());
+                CHECK(parallel == prefix);
+            }
+        }
+    }
+}
+
+void partitionsHoldExactPrefixes() {
+    std::mt19937_64 random(4);
+    for (size_t trial = 0; trial < 200; ++trial) {
+        std::vector<Tagged> expected;
+        std::vector<std::vector<Tagged>> tagged = tag(randomRuns(random, 1 + trial % 11, 80, trial % 2 == 0 ? 3 : 500), expected);
+        std::vector<TaggedRun> runs = spans(tagged);
+
+        for (size_t rank = 0; rank <= expected.size(); rank += 1 + expected.size() / 17) {
+            std::vector<size_t> offsets = Merge::partitionRuns(runs, rank, keyOf);
+            CHECK(offsets.size() == runs.size());
+
+            // The prefixes cut at the offsets hold exactly the first <rank> outputs
+            std::vector<Tagged> prefix;
+            for (size_t r = 0; r < tagged.size(); ++r) {
+                CHECK(offsets[r] <= tagged[r].size());
+                prefix.insert(prefix.end(), tagged[r].begin(), tagged[r].begin() + std::min(offsets[r], tagged[r].size()));
+            }
+            std::sort(prefix.begin(), prefix.end());
+            std::vector<Tagged> want(expected.begin(), expected.begin() + rank);
+            std::sort(want.begin(), want.end());
+            CHECK(prefix == want);
+        }
+    }
+}
+}
+
+int main() {
+    treeYieldsEveryKeyInOrder();
+    emptyTrees();
+    rankingMergeMatchesSortedUnion();
+    mergesMatchStableSort();
+    partitionsHoldExactPrefixes();
+    return checkResult("LoserTreeTest");
+}
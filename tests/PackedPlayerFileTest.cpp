@@ -0,0 +1,251 @@
+#include "Check.hpp"
+#include "PackedPlayerFile.hpp"
+#include "PrefetchPlayerStream.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+std::string tempPath(const char* tag) {
+    return "/tmp/PackedPlayerFileTest-" + std::to_string(::getpid()) + "-" + tag + ".pk";
+}
+
+std::vector<Player> samplePlayers(size_t count) {
+    std::vector<Player> players;
+    for (size_t i = 0; i < count; ++i) {
+        // Repeated, empty & heap-allocated names; levels spanning the full width
+        std::string name = i % 5 == 0 ? "" : "player-" + std::string(i % 23, 'x') + std::to_string(i % 97);
+        size_t level = i % 11 == 0 ? SIZE_MAX - i : (i * 7919) % 100000;
+        Player player(name, level);
+        player.id_ = i % 3 == 0 ? 1000000 - i : i * 13; // Deltas of both signs
+        players.push_back(player);
+    }
+    return players;
+}
+
+bool samePlayer(const Player& a, const Player& b) {
+    return a.name_ == b.name_ && a.level_ == b.level_ && a.id_ == b.id_;
+}
+
+std::string readAll(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void writeAll(const std::string& path, const std::string& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+/**
+ * @brief Replays the archive at <path>, returning false if it is rejected.
+ */
+bool replays(const std::string& path) {
+    try {
+        PackedPlayerStream stream(path);
+        while (stream.remaining() > 0) {
+            stream.nextPlayer();
+        }
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Replays the archive at <path> through a PrefetchPlayerStream,
+ * returning false if it is rejected.
+ */
+bool prefetchReplays(const std::string& path, bool useIoUring) {
+    try {
+        PrefetchPlayerStream stream(path, 2, 1, useIoUring);
+        while (stream.remaining() > 0) {
+            stream.nextPlayer();
+        }
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+    return true;
+}
+
+void roundTrip() {
+    for (size_t blockSize : { 1, 7, 4096 }) {
+        for (size_t count : { 0, 1, 5, 4097, 20000 }) {
+            std::string path = tempPath("round-trip");
+            std::vector<Player> players = samplePlayers(count);
+            writePackedPlayerFile(path, players, blockSize);
+
+            PackedPlayerStream stream(path);
+            CHECK(stream.remaining() == count);
+            for (size_t i = 0; i < count; ++i) {
+                CHECK(samePlayer(stream.nextPlayer(), players[i]));
+            }
+            CHECK(stream.remaining() == 0);
+
+            // Batches straddling blocks, reusing the batch's Players
+            PackedPlayerStream batched(path);
+            std::vector<Player> batch;
+            size_t seen = 0;
+            while (batched.nextBatch(batch, 333) > 0) {
+                for (const Player& player : batch) {
+                    CHECK(seen < count && samePlayer(player, players[seen]));
+                    seen++;
+                }
+            }
+            CHECK(seen == count);
+            std::remove(path.c_str());
+        }
+    }
+}
+
+void streamOverloadMatchesVector() {
+    std::vector<Player> players = samplePlayers(10000);
+    std::string fromVector = tempPath("vector");
+    std::string fromStream = tempPath("stream");
+    writePackedPlayerFile(fromVector, players, 512);
+    VectorPlayerStream source(players);
+    writePackedPlayerFile(fromStream, source, 512);
+
+    CHECK(source.remaining() == 0);
+    CHECK(readAll(fromVector) == readAll(fromStream));
+    std::remove(fromVector.c_str());
+    std::remove(fromStream.c_str());
+}
+
+/**
+ * @brief Returns <bytes> with the uint32_t at <offset> into the first block's
+ * header replaced by <value>.
+ */
+std::string withBlockField(const std::string& bytes, size_t offset, uint32_t value) {
+    std::string corrupt = bytes;
+    std::memcpy(&corrupt[sizeof(PackedFileHeader) + offset], &value, sizeof(value));
+    return corrupt;
+}
+
+void rejectsTruncatedFiles() {
+    std::string path = tempPath("truncated");
+    writePackedPlayerFile(path, samplePlayers(5000), 256);
+    std::string bytes = readAll(path);
+    CHECK(replays(path));
+    CHECK(prefetchReplays(path, false) && prefetchReplays(path, true));
+
+    for (size_t length : { size_t(0), size_t(8), sizeof(PackedFileHeader) - 1, sizeof(PackedFileHeader), bytes.size() / 3, bytes.size() / 2,
+             bytes.size() - 9, bytes.size() - 1 }) {
+        writeAll(path, bytes.substr(0, length));
+        CHECK(!replays(path));
+    }
+
+    // Block headers claiming no Players, more than the block size, or more
+    // bytes than the block holds; a zero bit width makes the level words free
+    std::string zeroWidth = bytes;
+    zeroWidth[sizeof(PackedFileHeader) + 4] = 0;
+    for (const std::string& corrupt : { withBlockField(bytes, 0, 0), withBlockField(bytes, 0, 257),
+             withBlockField(zeroWidth, 0, UINT32_MAX), withBlockField(bytes, 13, UINT32_MAX),
+             withBlockField(bytes, 17, UINT32_MAX), withBlockField(bytes, 21, UINT32_MAX),
+             withBlockField(bytes, 17, 1) }) {
+        writeAll(path, corrupt);
+        CHECK(!replays(path));
+        CHECK(!prefetchReplays(path, false));
+        CHECK(!prefetchReplays(path, true));
+    }
+    std::remove(path.c_str());
+}
+
+void prefetchRoundTrip() {
+    std::vector<Player> players = samplePlayers(20000);
+    std::string path = tempPath("prefetch");
+    writePackedPlayerFile(path, players, 700);
+
+    for (bool useIoUring : { false, true }) {
+        for (size_t depth : { 1, 2, 8 }) {
+            for (size_t readSize : { size_t(1), size_t(5000), size_t(1) << 20 }) {
+                PrefetchPlayerStream stream(path, depth, readSize, useIoUring);
+                CHECK(useIoUring || !stream.usingIoUring());
+                std::vector<Player> batch;
+                size_t seen = 0;
+                while (stream.remaining() > 0) {
+                    if (seen % 2 == 0) {
+                        CHECK(samePlayer(stream.nextPlayer(), players[seen++]));
+                        continue;
+                    }
+                    stream.nextBatch(batch, 999);
+                    for (const Player& player : batch) {
+                        CHECK(seen < players.size() && samePlayer(player, players[seen]));
+                        seen++;
+                    }
+                }
+                CHECK(seen == players.size());
+            }
+        }
+    }
+    std::remove(path.c_str());
+}
+
+/**
+ * @brief Returns the size in bytes of the first block of the archive <bytes>.
+ */
+size_t firstBlockBytes(const std::string& bytes) {
+    const char* block = bytes.data() + sizeof(PackedFileHeader);
+    uint32_t wordCount, idBytes, nameBytes;
+    std::memcpy(&wordCount, block + 13, sizeof(wordCount));
+    std::memcpy(&idBytes, block + 17, sizeof(idBytes));
+    std::memcpy(&nameBytes, block + 21, sizeof(nameBytes));
+    return 25 + size_t(wordCount) * sizeof(uint64_t) + idBytes + nameBytes;
+}
+
+void prefetchFailsOnlyAtTheFailedUnit() {
+    const size_t blockSize = 500;
+    std::vector<Player> players = samplePlayers(20000);
+    std::string path = tempPath("prefetch-truncated");
+    writePackedPlayerFile(path, players, blockSize);
+    size_t cut = sizeof(PackedFileHeader) + firstBlockBytes(readAll(path)) + 1;
+
+    for (bool useIoUring : { false, true }) {
+        for (size_t depth : { 1, 4 }) {
+            writePackedPlayerFile(path, players, blockSize);
+            // One block per read; every read after the first fails once the file shrinks
+            PrefetchPlayerStream stream(path, depth, 1, useIoUring);
+            CHECK(::truncate(path.c_str(), static_cast<off_t>(cut)) == 0);
+
+            size_t seen = 0;
+            bool failed = false;
+            try {
+                while (stream.remaining() > 0) {
+                    CHECK(samePlayer(stream.nextPlayer(), players[seen]));
+                    seen++;
+                }
+            } catch (const std::runtime_error&) {
+                failed = true;
+            }
+            // Reads already in flight may have finished first, but never fewer than the intact unit
+            CHECK(failed);
+            CHECK(seen >= blockSize && seen < players.size());
+
+            bool failedAgain = false;
+            try {
+                stream.nextPlayer();
+            } catch (const std::runtime_error&) {
+                failedAgain = true;
+            }
+            CHECK(failedAgain);
+        }
+    }
+    std::remove(path.c_str());
+}
+}
+
+int main() {
+    roundTrip();
+    streamOverloadMatchesVector();
+    rejectsTruncatedFiles();
+    prefetchRoundTrip();
+    prefetchFailsOnlyAtTheFailedUnit();
+    return checkResult("PackedPlayerFileTest");
+}
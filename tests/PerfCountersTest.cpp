@@ -0,0 +1,76 @@
+#include "Check.hpp"
+#include "Leaderboard.hpp"
+#include "PerfCounters.hpp"
+
+#include <string>
+#include <vector>
+
+namespace {
+bool empty(const HardwareCounters& counters) {
+    return counters.available_ == 0 && counters.cycles_ == 0 && counters.instructions_ == 0 && counters.l1dMisses_ == 0
+        && counters.llcMisses_ == 0 && counters.branchMisses_ == 0 && counters.dtlbMisses_ == 0;
+}
+
+std::vector<Player> samplePlayers(size_t count) {
+    std::vector<Player> players;
+    for (size_t i = 0; i < count; ++i) {
+        players.emplace_back("p" + std::to_string(i), (i * 7919) % 1000);
+    }
+    return players;
+}
+
+void unavailableCollectorIsANoOp() {
+    PerfCollector collector(0);
+    CHECK(!collector.available());
+    collector.start();
+    CHECK(empty(collector.stop()));
+    // stop() without a start() is equally harmless
+    CHECK(empty(collector.stop()));
+}
+
+void withCountersKeepsTheResult() {
+    std::vector<Player> players = samplePlayers(1000);
+    VectorPlayerStream stream(players);
+    CountingInstrumentation counter;
+    const RankingResult expected = Online::rankIncoming(stream, 10, counter);
+
+    PerfCollector collector(0);
+    size_t calls = 0;
+    RankingResult result = withCounters(collector, [&]() {
+        calls++;
+        return expected;
+    });
+    CHECK(calls == 1);
+    CHECK(empty(result.counters_));
+    CHECK(result.top_.size() == expected.top_.size());
+    for (size_t i = 0; i < result.top_.size() && i < expected.top_.size(); ++i) {
+        CHECK(result.top_[i].name_ == expected.top_[i].name_ && result.top_[i].level_ == expected.top_[i].level_);
+    }
+    CHECK(result.cutoffs_ == expected.cutoffs_);
+    CHECK(result.elapsed_ == expected.elapsed_);
+    CHECK(result.stats_.comparisons_ == expected.stats_.comparisons_ && result.stats_.moves_ == expected.stats_.moves_);
+
+    // A real engine call, on whatever counters this host permits
+    PerfCollector host;
+    std::vector<Player> copy(players);
+    RankingResult ranked = withCounters(host, [&]() { return Offline::heapRank(copy); });
+    CHECK(ranked.top_.size() == 100);
+    CHECK(host.available() || empty(ranked.counters_));
+}
+
+void masksSelectCounters() {
+    // Only requested counters may ever be reported
+    PerfCollector collector(HardwareCounters::Instructions);
+    collector.start();
+    HardwareCounters counters = collector.stop();
+    CHECK((counters.available_ & ~unsigned(HardwareCounters::Instructions)) == 0);
+    CHECK(counters.cycles_ == 0 && counters.l1dMisses_ == 0);
+}
+}
+
+int main() {
+    unavailableCollectorIsANoOp();
+    withCountersKeepsTheResult();
+    masksSelectCounters();
+    return checkResult("PerfCountersTest");
+}
@@ -0,0 +1,150 @@
+#include "Check.hpp"
+#include "Leaderboard.hpp"
+#include "PlayerFile.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+std::string tempPath(const char* tag) {
+    return "/tmp/PlayerFileTest-" + std::to_string(::getpid()) + "-" + tag + ".plr";
+}
+
+std::vector<Player> samplePlayers(size_t count) {
+    std::vector<Player> players;
+    for (size_t i = 0; i < count; ++i) {
+        // Mix of short & heap-allocated names, including an empty one
+        Player player(i == 3 ? "" : "player-" + std::string(i % 40, 'x') + std::to_string(i), (i * 7919) % 1000);
+        player.id_ = i * 3 + 1;
+        players.push_back(player);
+    }
+    return players;
+}
+
+std::string readAll(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void writeAll(const std::string& path, const std::string& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+bool rejects(const std::string& path) {
+    try {
+        PlayerFile file(path);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+void roundTrip() {
+    for (size_t count : { 0, 1, 5, 1000 }) {
+        std::string path = tempPath("round-trip");
+        std::vector<Player> players = samplePlayers(count);
+        writePlayerFile(path, players);
+
+        PlayerFile file(path);
+        CHECK(file.size() == count);
+        for (size_t i = 0; i < file.size() && i < count; ++i) {
+            Player player = file.player(i);
+            CHECK(player.name_ == players[i].name_);
+            CHECK(player.level_ == players[i].level_);
+            CHECK(player.id_ == players[i].id_);
+        }
+
+        MmapPlayerStream stream(file);
+        size_t streamed = 0;
+        while (stream.remaining() > 0) {
+            CHECK(stream.nextPlayer().name_ == players[streamed++].name_);
+        }
+        CHECK(streamed == count);
+        std::remove(path.c_str());
+    }
+}
+
+void rejectsTruncatedFiles() {
+    std::string path = tempPath("truncated");
+    writePlayerFile(path, samplePlayers(100));
+    std::string bytes = readAll(path);
+
+    for (size_t length : { size_t(0), size_t(8), sizeof(PlayerFileHeader) - 1, sizeof(PlayerFileHeader) + 16, bytes.size() / 2, bytes.size() - 1 }) {
+        writeAll(path, bytes.substr(0, length));
+        CHECK(rejects(path));
+    }
+    std::remove(path.c_str());
+}
+
+void rejectsCraftedHeaders() {
+    std::string path = tempPath("crafted");
+    writePlayerFile(path, samplePlayers(100));
+    const std::string bytes = readAll(path);
+
+    auto withHeader = [&](auto edit) {
+        std::string crafted = bytes;
+        PlayerFileHeader header;
+        std::memcpy(&header, crafted.data(), sizeof(header));
+        edit(header);
+        std::memcpy(&crafted[0], &header, sizeof(header));
+        writeAll(path, crafted);
+        return rejects(path);
+    };
+
+    // Offsets that wrap offset + count * 8 back inside the mapping
+    CHECK(withHeader([](PlayerFileHeader& h) { h.levelsOffset_ = UINT64_MAX - 7; }));
+    CHECK(withHeader([](PlayerFileHeader& h) { h.idsOffset_ = UINT64_MAX - 7; }));
+    CHECK(withHeader([](PlayerFileHeader& h) { h.nameOffsetsOffset_ = UINT64_MAX - 7; }));
+    CHECK(withHeader([](PlayerFileHeader& h) { h.namesSize_ = UINT64_MAX - h.namesOffset_ + 1; }));
+    CHECK(withHeader([](PlayerFileHeader& h) { h.count_ = UINT64_MAX / 8 + 1; }));
+
+    // Columns that cannot be read in place as uint64_t
+    CHECK(withHeader([](PlayerFileHeader& h) { h.levelsOffset_ += 1; }));
+    CHECK(withHeader([](PlayerFileHeader& h) { h.idsOffset_ += 4; }));
+    CHECK(withHeader([](PlayerFileHeader& h) { h.nameOffsetsOffset_ += 2; }));
+
+    CHECK(withHeader([](PlayerFileHeader& h) { h.magic_[0] = 'X'; }));
+    CHECK(!withHeader([](PlayerFileHeader&) {}));
+    std::remove(path.c_str());
+}
+
+void enginesMatchQuickSelectRank() {
+    // Top 10% of 1..640 Players goes through SmallTopK; larger ones by quickselect or heap
+    for (size_t count : { 0, 1, 9, 10, 11, 639, 640, 641, 651, 5000 }) {
+        std::string path = tempPath("engines");
+        std::vector<Player> players = samplePlayers(count);
+        writePlayerFile(path, players);
+        std::vector<Player> source(players);
+        RankingResult expected = Offline::quickSelectRank(source);
+
+        PlayerFile file(path);
+        for (const RankingResult& result : { Offline::quickSelectRank(file), Offline::heapRank(file) }) {
+            CHECK(result.top_.size() == expected.top_.size());
+            CHECK(result.cutoffs_.empty());
+            for (size_t i = 0; i < result.top_.size() && i < expected.top_.size(); ++i) {
+                CHECK(result.top_[i].level_ == expected.top_[i].level_);
+                // Ties may pick other rows, but each must be materialized from its own row
+                const Player& player = result.top_[i];
+                size_t row = (player.id_ - 1) / 3;
+                CHECK(row < count && player.name_ == players[row].name_ && player.level_ == players[row].level_);
+            }
+        }
+        std::remove(path.c_str());
+    }
+}
+}
+
+int main() {
+    roundTrip();
+    rejectsTruncatedFiles();
+    rejectsCraftedHeaders();
+    enginesMatchQuickSelectRank();
+    return checkResult("PlayerFileTest");
+}
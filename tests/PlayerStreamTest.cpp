@@ -0,0 +1,66 @@
+#include "Check.hpp"
+#include "PlayerStream.hpp"
+
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// A span over a temporary would dangle, so it must not compile
+static_assert(!std::is_constructible<PlayerSpanStream, std::vector<Player>&&>::value, "PlayerSpanStream must not bind temporaries");
+static_assert(std::is_constructible<PlayerSpanStream, std::vector<Player>&>::value, "PlayerSpanStream must accept lvalues");
+static_assert(!std::is_final<VectorPlayerStream>::value, "VectorPlayerStream stays open to subclassing");
+
+namespace {
+std::vector<Player> samplePlayers() {
+    return { Player("Rykard", 23), Player("Malenia", 99), Player("", 0) };
+}
+
+bool throwsRuntimeError(PlayerStream& stream) {
+    try {
+        stream.nextPlayer();
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+void checkStreamsInOrder(PlayerStream& stream, const std::vector<Player>& players) {
+    CHECK(stream.remaining() == players.size());
+    for (const Player& expected : players) {
+        Player player = stream.nextPlayer();
+        CHECK(player.name_ == expected.name_ && player.level_ == expected.level_);
+    }
+    CHECK(stream.remaining() == 0);
+    CHECK(throwsRuntimeError(stream));
+}
+
+void vectorStream() {
+    std::vector<Player> players = samplePlayers();
+    VectorPlayerStream copied(players);
+    checkStreamsInOrder(copied, players);
+    CHECK(players.size() == 3 && players[0].name_ == "Rykard"); // The source is left intact
+
+    VectorPlayerStream moved(samplePlayers());
+    checkStreamsInOrder(moved, players);
+}
+
+void spanStream() {
+    std::vector<Player> players = samplePlayers();
+    PlayerSpanStream whole(players);
+    checkStreamsInOrder(whole, players);
+
+    PlayerSpanStream tail(players.data() + 1, players.data() + players.size());
+    CHECK(&tail.nextPlayerRef() == &players[1]); // Lent, not copied
+    CHECK(tail.nextPlayer().name_.empty());
+    CHECK(tail.remaining() == 0);
+
+    PlayerSpanStream empty(players.data(), players.data());
+    CHECK(throwsRuntimeError(empty));
+}
+}
+
+int main() {
+    vectorStream();
+    spanStream();
+    return checkResult("PlayerStreamTest");
+}
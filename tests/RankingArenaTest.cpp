@@ -0,0 +1,120 @@
+#include "Check.hpp"
+#include "Leaderboard.hpp"
+#include "RankingArena.hpp"
+
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+/**
+ * @brief A memory resource counting the requests it forwards to the global heap.
+ */
+class CountingResource final : public std::pmr::memory_resource {
+public:
+    size_t allocations_ = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        allocations_++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+std::vector<Player> sampleBoard(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<Player> players;
+    for (size_t i = 0; i < count; ++i) {
+        players.emplace_back("p" + std::to_string(i), rng() % 5000);
+    }
+    return players;
+}
+
+std::vector<size_t> levels(const std::vector<Player>& players) {
+    std::vector<size_t> result;
+    for (const Player& player : players) {
+        result.push_back(player.level_);
+    }
+    return result;
+}
+
+std::vector<size_t> levels(const std::pmr::vector<Player>& players) {
+    return levels(std::vector<Player>(players.begin(), players.end()));
+}
+
+void batchFitsInTheArena() {
+    const size_t boards = 20;
+    const size_t count = 1000;
+    const size_t interval = 100;
+    const size_t topCount = (count + 9) / 10;
+    const size_t milestones = (count + interval - 1) / interval;
+
+    CountingResource upstream;
+    // One quickSelectRank, heapRank & rankIncoming result per board
+    RankingArena arena(RankingArena::bytesFor(3 * boards, topCount, milestones), &upstream);
+
+    for (size_t board = 0; board < boards; ++board) {
+        const std::vector<Player> players = sampleBoard(count, board);
+
+        std::vector<Player> copy(players);
+        RankingResult expected = Offline::quickSelectRank(copy);
+
+        copy = players;
+        PmrRankingResult quick = Offline::quickSelectRank(copy, arena.resource());
+        CHECK(levels(quick.top_) == levels(expected.top_) && quick.cutoffs_.empty());
+        CHECK(quick.top_.get_allocator().resource() == arena.resource());
+
+        copy = players;
+        PmrRankingResult heap = Offline::heapRank(copy, arena.resource());
+        CHECK(levels(heap.top_) == levels(expected.top_) && heap.cutoffs_.empty());
+
+        VectorPlayerStream stream(players);
+        RankingResult online = Online::rankIncoming(stream, interval);
+        VectorPlayerStream pmrStream(players);
+        PmrRankingResult incoming = Online::rankIncoming(pmrStream, interval, arena.resource());
+        CHECK(levels(incoming.top_) == levels(online.top_));
+        CHECK(incoming.cutoffs_.size() == online.cutoffs_.size());
+        for (const auto& [count, cutoff] : online.cutoffs_) {
+            CHECK(incoming.cutoffs_.count(count) == 1 && incoming.cutoffs_.at(count) == cutoff);
+        }
+    }
+    // bytesFor() covered the whole batch, so nothing fell back to the heap
+    CHECK(upstream.allocations_ == 0);
+
+    // Once released, the arena serves a second batch from the same buffer
+    arena.release();
+    std::vector<Player> players = sampleBoard(count, boards);
+    for (size_t i = 0; i < 3 * boards; ++i) {
+        std::vector<Player> copy(players);
+        Offline::heapRank(copy, arena.resource());
+    }
+    CHECK(upstream.allocations_ == 0);
+}
+
+void overflowFallsBackUpstream() {
+    CountingResource upstream;
+    RankingArena arena(RankingArena::bytesFor(1, 10), &upstream);
+    CHECK(arena.capacity() == RankingArena::bytesFor(1, 10));
+
+    std::vector<Player> players = sampleBoard(1000, 7);
+    std::vector<Player> copy(players);
+    PmrRankingResult result = Offline::quickSelectRank(copy, arena.resource());
+    CHECK(result.top_.size() == 100);
+    CHECK(upstream.allocations_ > 0);
+}
+}
+
+int main() {
+    batchFitsInTheArena();
+    overflowFallsBackUpstream();
+    return checkResult("RankingArenaTest");
+}
@@ -0,0 +1,100 @@
+#include "Check.hpp"
+#include "ShardedRank.hpp"
+#include "Workload.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace {
+std::vector<size_t> levelsOf(const std::vector<Player>& players) {
+    std::vector<size_t> levels;
+    for (const Player& player : players) {
+        levels.push_back(player.level_);
+    }
+    return levels;
+}
+
+/**
+ * @brief Deals <players> out to <count> shards in uneven contiguous slices,
+ * leaving the last shard empty when there is more than one.
+ */
+std::vector<std::vector<Player>> deal(const std::vector<Player>& players, size_t count) {
+    std::vector<std::vector<Player>> shards(count);
+    size_t filled = count > 1 ? count - 1 : 1;
+    size_t begin = 0;
+    for (size_t s = 0; s < filled; ++s) {
+        // Shard s gets a share proportional to s + 1
+        size_t end = s + 1 == filled ? players.size() : begin + players.size() * 2 * (s + 1) / (filled * (filled + 1));
+        shards[s].assign(players.begin() + begin, players.begin() + end);
+        begin = end;
+    }
+    return shards;
+}
+
+/**
+ * @brief Checks shardedRank() over <shards> ranks the same levels as
+ * quickSelectRank() over their union, each a distinct Player of some shard,
+ * while shipping few more than topCount Players.
+ */
+void checkAgainstQuickSelect(const std::vector<std::vector<Player>>& shards) {
+    std::vector<Player> all;
+    for (const std::vector<Player>& shard : shards) {
+        all.insert(all.end(), shard.begin(), shard.end());
+    }
+    std::vector<Player> copy = all;
+    std::vector<Player> expected = Offline::quickSelectRank(copy).top_;
+
+    ShardedRankingResult result = Offline::shardedRank(shards);
+    const std::vector<Player>& top = result.ranking_.top_;
+    CHECK(result.shards_ == shards.size());
+    // Short of an exact cutoff, up to max(shards, topCount / 64) surplus Players ship
+    CHECK(result.candidates_ >= expected.size());
+    CHECK(result.candidates_ <= expected.size() + std::max(shards.size(), expected.size() / 64));
+    CHECK(levelsOf(top) == levelsOf(expected));
+
+    std::vector<size_t> ids;
+    for (const Player& player : all) {
+        ids.push_back(player.id_);
+    }
+    std::sort(ids.begin(), ids.end());
+    std::vector<size_t> topIds;
+    for (const Player& player : top) {
+        CHECK(std::binary_search(ids.begin(), ids.end(), player.id_));
+        topIds.push_back(player.id_);
+    }
+    std::sort(topIds.begin(), topIds.end());
+    CHECK(std::adjacent_find(topIds.begin(), topIds.end()) == topIds.end());
+}
+
+void matchesQuickSelect() {
+    const Distribution distributions[] = { Distribution::Uniform, Distribution::Zipf, Distribution::FewDistinct, Distribution::Ascending };
+    for (Distribution distribution : distributions) {
+        WorkloadSpec spec;
+        spec.distribution_ = distribution;
+        for (size_t count : { 0, 1, 10, 997, 100000 }) {
+            std::vector<Player> players = generateWorkload(spec, count, 1);
+            for (size_t shards : { 1, 2, 3, 8 }) {
+                checkAgainstQuickSelect(deal(players, shards));
+            }
+        }
+    }
+}
+
+void allTiedAcrossShards() {
+    // Every Player ties at the cutoff, so the shards must split the ties exactly
+    std::vector<Player> players;
+    for (size_t i = 0; i < 1001; ++i) {
+        Player player("p" + std::to_string(i), 42);
+        player.id_ = i;
+        players.push_back(player);
+    }
+    checkAgainstQuickSelect(deal(players, 5));
+}
+}
+
+int main() {
+    matchesQuickSelect();
+    allTiedAcrossShards();
+    return checkResult("ShardedRankTest");
+}
@@ -0,0 +1,160 @@
+#include "Check.hpp"
+#include "CsvRoster.hpp"
+#include "Leaderboard.hpp"
+#include "SmallTopK.hpp"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+/**
+ * @brief Random, tied, ascending, descending & constant level sequences.
+ */
+std::vector<std::vector<uint64_t>> sampleLevels(size_t count) {
+    std::mt19937_64 rng(count);
+    std::vector<std::vector<uint64_t>> sequences(5);
+    for (size_t i = 0; i < count; ++i) {
+        sequences[0].push_back(rng()); // Full width, so the sign-bit bias matters
+        sequences[1].push_back(rng() % 7);
+        sequences[2].push_back(i);
+        sequences[3].push_back(count - i);
+        sequences[4].push_back(42);
+    }
+    return sequences;
+}
+
+std::vector<Player> toPlayers(const std::vector<uint64_t>& levels) {
+    std::vector<Player> players;
+    for (size_t i = 0; i < levels.size(); ++i) {
+        players.emplace_back("player" + std::to_string(i), levels[i]);
+    }
+    return players;
+}
+
+std::vector<size_t> levelsOf(const std::vector<Player>& players) {
+    std::vector<size_t> result;
+    for (const Player& player : players) {
+        result.push_back(player.level_);
+    }
+    return result;
+}
+
+bool constructs(size_t capacity, SmallTopK::Kernel kernel) {
+    try {
+        SmallTopK board(capacity, kernel);
+    } catch (const std::invalid_argument&) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Pushes every level through a board using <kernel>, checking each
+ * result against a sorted reference, & returns the slots handed out.
+ */
+std::vector<size_t> checkBoard(size_t k, const std::vector<uint64_t>& levels, SmallTopK::Kernel kernel) {
+    SmallTopK board(k, kernel);
+    std::vector<uint64_t> expected; // Ascending top k so far
+    std::vector<uint64_t> payload(k); // The level stored in each slot
+    std::vector<size_t> slots;
+
+    for (uint64_t level : levels) {
+        bool accepted = expected.size() < k || level > expected.front();
+        size_t slot = board.push(level);
+        slots.push_back(slot);
+        CHECK((slot == SmallTopK::REJECTED) == !accepted);
+        if (!accepted) {
+            continue;
+        }
+        if (expected.size() == k) {
+            expected.erase(expected.begin());
+        }
+        expected.insert(std::upper_bound(expected.begin(), expected.end(), level), level);
+        CHECK(slot < k);
+        if (slot < k) {
+            payload[slot] = level;
+        }
+    }
+
+    CHECK(board.size() == expected.size() && board.capacity() == k);
+    for (size_t i = 0; i < board.size() && i < expected.size(); ++i) {
+        CHECK(board.level(i) == expected[i]);
+        CHECK(payload[board.slot(i)] == expected[i]);
+    }
+    CHECK(expected.empty() || board.cutoff() == expected.front());
+    return slots;
+}
+
+void boardsMatchReference() {
+    CHECK(!constructs(0, SmallTopK::Kernel::Best));
+    CHECK(!constructs(SmallTopK::MAX_K + 1, SmallTopK::Kernel::Best));
+    CHECK(constructs(SmallTopK::MAX_K, SmallTopK::Kernel::Scalar));
+    CHECK(constructs(1, SmallTopK::Kernel::Avx2) == SmallTopK::hasAvx2());
+
+    for (size_t k = 1; k <= SmallTopK::MAX_K; ++k) {
+        for (const std::vector<uint64_t>& levels : sampleLevels(300)) {
+            std::vector<size_t> scalar = checkBoard(k, levels, SmallTopK::Kernel::Scalar);
+            // The kernels must agree slot for slot, not just on the final board
+            if (SmallTopK::hasAvx2()) {
+                CHECK(checkBoard(k, levels, SmallTopK::Kernel::Avx2) == scalar);
+            }
+        }
+    }
+}
+
+/**
+ * @brief rankIncoming() ranks boards of k <= 64 with SmallTopK; the
+ * instrumented overload always uses the heap, so the two must agree.
+ */
+void rankIncomingMatchesHeapPath() {
+    for (size_t k = 1; k <= SmallTopK::MAX_K + 1; ++k) {
+        for (const std::vector<uint64_t>& levels : sampleLevels(500)) {
+            std::vector<Player> players = toPlayers(levels);
+            VectorPlayerStream small(players);
+            RankingResult result = Online::rankIncoming(small, k);
+
+            VectorPlayerStream heap(players);
+            CountingInstrumentation counting;
+            RankingResult expected = Online::rankIncoming(heap, k, counting);
+            CHECK(levelsOf(result.top_) == levelsOf(expected.top_));
+            CHECK(result.cutoffs_ == expected.cutoffs_);
+        }
+    }
+}
+
+/**
+ * @brief The columnar engines select rosters whose top 10% is at most 64
+ * Players with SmallTopK, & larger ones by quickselect or a heap.
+ */
+void columnarEnginesMatchHeapPath() {
+    for (size_t topCount = 1; topCount <= SmallTopK::MAX_K + 1; ++topCount) {
+        for (std::vector<uint64_t> levels : sampleLevels(topCount * 10)) {
+            // Text levels have at most 19 digits
+            for (uint64_t& level : levels) {
+                level >>= 1;
+            }
+            std::string text;
+            for (size_t i = 0; i < levels.size(); ++i) {
+                text += "player" + std::to_string(i) + "," + std::to_string(levels[i]) + "\n";
+            }
+            CsvRoster roster = parseCsvRoster(text.data(), text.size(), 3);
+
+            std::vector<Player> players = toPlayers(levels);
+            RankingResult expected = Offline::heapRank(players);
+            CHECK(expected.top_.size() == topCount);
+            CHECK(levelsOf(Offline::quickSelectRank(roster).top_) == levelsOf(expected.top_));
+            CHECK(levelsOf(Offline::heapRank(roster).top_) == levelsOf(expected.top_));
+        }
+    }
+}
+}
+
+int main() {
+    boardsMatchReference();
+    rankIncomingMatchesHeapPath();
+    columnarEnginesMatchHeapPath();
+    return checkResult("SmallTopKTest");
+}
@@ -0,0 +1,142 @@
+#include "Check.hpp"
+#include "Workload.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace {
+size_t comparisons = 0;
+
+size_t medianOf3(size_t a, size_t b, size_t c) {
+    if (a < b) {
+        return b < c ? b : (a < c ? c : a);
+    }
+    return a < c ? a : (b < c ? c : b);
+}
+
+/**
+ * @brief The first/middle/last median-of-3 quicksort Musser's sequence targets,
+ * counting comparisons made while partitioning.
+ */
+void medianOf3Sort(size_t* first, size_t* last) {
+    while (last - first > 1) {
+        size_t pivot = medianOf3(*first, first[(last - first) / 2], last[-1]);
+        size_t* left = first;
+        size_t* right = last;
+        while (true) {
+            while (*left < pivot) {
+                ++left;
+                comparisons++;
+            }
+            --right;
+            while (pivot < *right) {
+                --right;
+                comparisons++;
+            }
+            if (!(left < right)) {
+                break;
+            }
+            std::swap(*left, *right);
+            ++left;
+        }
+        medianOf3Sort(left, last);
+        last = left;
+    }
+}
+
+std::vector<size_t> levels(const WorkloadSpec& spec, size_t count) {
+    std::vector<size_t> result;
+    for (const Player& player : generateWorkload(spec, count, 1)) {
+        result.push_back(player.level_);
+    }
+    return result;
+}
+
+void killerIsPermutation() {
+    WorkloadSpec spec;
+    spec.distribution_ = Distribution::QuickselectKiller;
+    for (size_t count = 0; count <= 300; ++count) {
+        std::vector<size_t> sorted = levels(spec, count);
+        std::sort(sorted.begin(), sorted.end());
+        bool permutation = sorted.size() == count;
+        for (size_t i = 0; permutation && i < count; ++i) {
+            permutation = sorted[i] == i + 1;
+        }
+        CHECK(permutation);
+    }
+}
+
+void killerDefeatsMedianOf3() {
+    WorkloadSpec spec;
+    spec.distribution_ = Distribution::QuickselectKiller;
+    for (size_t count : { 4000, 4001, 4002, 4003 }) {
+        std::vector<size_t> killer = levels(spec, count);
+        comparisons = 0;
+        medianOf3Sort(killer.data(), killer.data() + count);
+        CHECK(comparisons > count * count / 16); // Quadratic, not ~N log N
+        CHECK(std::is_sorted(killer.begin(), killer.end()));
+    }
+}
+
+void sameOutputForAnyThreadCount() {
+    WorkloadSpec spec;
+    spec.distribution_ = Distribution::Zipf;
+    std::vector<Player> single = generateWorkload(spec, 200000, 1);
+    std::vector<Player> many = generateWorkload(spec, 200000, 4);
+    CHECK(single.size() == many.size());
+    for (size_t i = 0; i < single.size() && i < many.size(); ++i) {
+        CHECK(single[i].level_ == many[i].level_ && single[i].id_ == many[i].id_);
+    }
+}
+
+void fullWidthLevels() {
+    // maxLevel_ + 1 wraps to 0, & (double) SIZE_MAX rounds up past every size_t
+    WorkloadSpec spec;
+    spec.maxLevel_ = SIZE_MAX;
+    const size_t count = 4096;
+
+    for (Distribution distribution : { Distribution::Uniform, Distribution::Normal }) {
+        spec.distribution_ = distribution;
+        size_t high = 0;
+        size_t low = 0;
+        for (size_t i = 0; i < count; ++i) {
+            size_t level = workloadLevel(spec, count, i);
+            high += level >= SIZE_MAX / 4 * 3;
+            low += level < SIZE_MAX / 4;
+        }
+        // Uniform puts ~1/4 of its levels in each outer quarter, Normal (sigma = 1/8) ~2.3%
+        if (distribution == Distribution::Uniform) {
+            CHECK(high > count / 5 && low > count / 5);
+        } else {
+            CHECK(high > 0 && high < count / 10 && low > 0 && low < count / 10);
+        }
+    }
+
+    spec.distribution_ = Distribution::Zipf;
+    size_t distinct = 0;
+    for (size_t i = 0; i < count; ++i) {
+        distinct += workloadLevel(spec, count, i) != workloadLevel(spec, count, 0);
+    }
+    CHECK(distinct > count / 2);
+
+    // A skew of 0 is uniform over [1, maxLevel_]
+    spec.zipfSkew_ = 0.0;
+    size_t high = 0;
+    for (size_t i = 0; i < count; ++i) {
+        size_t level = workloadLevel(spec, count, i);
+        high += level >= SIZE_MAX / 4 * 3;
+        CHECK(level > 0);
+    }
+    CHECK(high > count / 5);
+}
+}
+
+int main() {
+    killerIsPermutation();
+    killerDefeatsMedianOf3();
+    sameOutputForAnyThreadCount();
+    fullWidthLevels();
+    return checkResult("WorkloadTest");
+}